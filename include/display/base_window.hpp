@@ -19,6 +19,8 @@ class BaseWindow {
     int Run();
 
     protected:
+    // Runs before glfwInit, where platform init hints have to be set
+    virtual void ConfigurePlatform() {}
     virtual void Initialize() = 0;
     virtual void LoadContent() = 0;
     virtual void Update() = 0;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// The six planes of a view frustum (left, right, bottom, top, near, far), normals
+// pointing inwards and normalized, so dot(normal, p) + w is the signed distance
+// from p to the plane.
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // Gribb & Hartmann: each plane is row 3 of projection * view plus or minus row 0, 1 or 2
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+    bool SphereVisible(const glm::vec3& center, float radius) const;
+};
+
+// Shadow projected from a point light onto the horizontal plane y = height
+struct PlanarShadow {
+    glm::vec3 light;
+    float height;
+};
+
+// Bits written by CullBoids, one byte per boid
+const uint8_t CULL_BOID_VISIBLE = 1;
+const uint8_t CULL_SHADOW_VISIBLE = 2;
+
+struct CullCounts {
+    size_t boids = 0;
+    size_t shadows = 0;
+};
+
+// Tests boids [begin, end) against the frustum. A boid is the sphere of 'radius'
+// around its position; its shadow is tested as a sphere around the shadow of that
+// position, grown to hold the shadow of the whole boid. Boids at or above the light
+// have no bounded shadow and always keep it.
+//
+// 'positions' points at the position of boid 0 and boids are 'stride' bytes apart.
+// Every record must hold at least 4 floats from the position on: the SSE path loads
+// 4 records as 4 vectors and transposes them.
+CullCounts CullBoids(const Frustum& frustum, const PlanarShadow& shadow, float radius,
+                     const float* positions, size_t stride, size_t begin, size_t end, uint8_t* flags);
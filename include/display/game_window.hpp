@@ -1,11 +1,43 @@
+#pragma once
+
 #include "display/base_window.hpp"
+#include <cstdint>
+#include <string>
+
+// Modo benchmark de render (--render-bench): janela oculta, cena fixa e N frames medidos
+struct RenderBenchOptions {
+    bool enabled = false;
+    // Plataforma nula do GLFW (contexto OSMesa): não precisa de servidor gráfico
+    bool offscreen = false;
+    int frames = 600;
+    int warmupFrames = 60;
+    int boids = 2000;
+    uint64_t seed = 1;
+    bool instanced = true;
+    // Câmera (0-3, como as teclas) e frustum culling dos boids
+    int camera = 0;
+    bool frustumCulling = true;
+    std::string outFile;
+};
 
 class GameWindow : public BaseWindow {
     public:
+    RenderBenchOptions renderBench;
+    // Snapshot do bando salvo com F5 e carregado com F6 (e na abertura, se loadSnapshot)
+    std::string snapshotFile = "flock.snapshot";
+    bool loadSnapshot = false;
+    // Gravação de trajetórias ligada/desligada com F7 (desde a abertura, se recordTrajectory)
+    std::string trajectoryFile = "flock.traj";
+    bool recordTrajectory = false;
+    // Log de entrada (comandos e passos) ligado/desligado com F4, para boids-headless --replay
+    std::string inputLogFile = "flock.inputlog";
+    bool recordInput = false;
+
     GameWindow(int width, int height, std::string title) : BaseWindow(width, height, title) {};
+    void ConfigurePlatform();
     void Initialize();
     void LoadContent();
     void Update();
     void Render();
     void Unload();
-};
\ No newline at end of file
+};
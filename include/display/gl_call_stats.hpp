@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// GL calls issued since the last Reset(), counted by swapping glad's function
+// pointers for counting wrappers. Nothing is counted (or slowed down) until
+// Install() is called, so only the render benchmark pays for it.
+struct GlCallStats {
+    uint64_t drawCalls;
+    uint64_t uniformUpdates;
+    uint64_t programBinds;
+    uint64_t vertexArrayBinds;
+    uint64_t bufferBinds;
+    uint64_t textureBinds;
+    uint64_t capabilityToggles;   // glEnable/glDisable
+    uint64_t bufferUploads;       // glBufferData/glBufferSubData with data, write mappings
+    uint64_t bufferUploadBytes;
+};
+
+class GlCallCounter {
+    public:
+    // Needs glad to be loaded; call again after reloading glad
+    static void Install();
+    static void Uninstall();
+    static bool Installed();
+
+    static void Reset();
+    static GlCallStats Stats();
+};
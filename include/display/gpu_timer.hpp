@@ -0,0 +1,30 @@
+#pragma once
+
+#include "utils/profiler.hpp"
+
+// GPU time of one pass, measured with GL_TIME_ELAPSED queries.
+// Queries go into a small ring and are read back frames later, only once the
+// driver reports them available, so measuring never stalls the CPU on the GPU.
+class GpuTimer {
+    public:
+    TimingHistory history;
+
+    GpuTimer();
+
+    // Needs a current GL context
+    void Create();
+    void Destroy();
+
+    void Begin();
+    void End();
+    // Moves every finished query into history; call once per frame
+    void Collect();
+
+    private:
+    static const int QUERY_COUNT = 4;
+
+    unsigned int queries[QUERY_COUNT];
+    int oldest;   // first query still waiting for its result
+    int inFlight; // queries issued and not yet collected
+    bool active;  // Begin() issued a query this pass
+};
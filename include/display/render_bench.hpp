@@ -0,0 +1,25 @@
+#pragma once
+
+#include "display/gl_call_stats.hpp"
+#include <string>
+#include <vector>
+
+// Samples of the render benchmark mode (--render-bench): CPU time to submit one
+// frame (scene + ImGui, up to SwapBuffers), time spent in SwapBuffers + glFinish
+// (the software rasterizer's work on llvmpipe) and the GL calls the frame issued.
+struct RenderBenchFrame {
+    float submitMs;
+    float finishMs;
+    GlCallStats calls;
+};
+
+class RenderBenchReport {
+    public:
+    std::string renderer;   // GL_RENDERER string
+    std::string scene;      // free-form description (boids, instanced...)
+    std::vector<RenderBenchFrame> frames;
+
+    void Add(const RenderBenchFrame& frame) { frames.push_back(frame); }
+    void Print() const;
+    bool WriteJson(const std::string& path) const;
+};
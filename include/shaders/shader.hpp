@@ -4,34 +4,76 @@
 #include "glfw3.h"
 #include <string>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 #include <glm/glm.hpp>
 
+class FileWatcher;
+class ShaderCompiler;
+
+// Index into a Shader's handle table. Handles survive ReloadFromFile, since the
+// table is re-resolved against the new program, so they can be fetched once
+// at load time and used in hot paths without any string lookup.
+struct UniformHandle {
+    int index = -1;
+};
+
 class Shader {
     public:
     unsigned int programID;
     std::string vertexFile;
     std::string fragmentFile;
 
-    long fragmentModTimeOnLoad;
+    // Sum of the watcher's versions of both files when the program was built
+    uint64_t fileVersionOnLoad;
+    // Compiler ticket of a rebuild not swapped in yet (0 = none), and the version it builds
+    uint64_t pendingBuild;
+    uint64_t pendingVersion;
 
     Shader();
     void Unload();
-    void ReloadFromFile();
+    // Starts a rebuild in the background if the watcher saw the vertex or fragment
+    // file change, and swaps it in once it linked. Until then, and for good if it
+    // fails, programID keeps pointing at the old program. Edits saved during a build
+    // start another one as soon as it lands.
+    void ReloadFromFile(const FileWatcher& watcher, ShaderCompiler& compiler);
+    bool ReloadPending() const { return pendingBuild != 0; }
     static Shader LoadShader(std::string fileVertexShader, std::string fileFragmentShader);
     
     // Ativa o shader
     void use() const;
+    // Location cached when the program was linked (-1 if not an active uniform)
+    int GetUniformLocation(const std::string &name) const;
+    // Registers a uniform name and returns a handle for the set*(UniformHandle) overloads
+    UniformHandle GetUniformHandle(const std::string &name);
+
     // Funções para facilitar o envio de dados para o shader
     void setBool(const std::string &name, bool value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string &name, float value) const;
     void setVec3(const std::string &name, const glm::vec3 &value) const;
     void setVec3(const std::string &name, float x, float y, float z) const;
+    void setMat3(const std::string &name, const glm::mat3 &mat) const;
     void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    // Same setters through handles: no hashing, no string allocation
+    void setBool(UniformHandle handle, bool value) const;
+    void setInt(UniformHandle handle, int value) const;
+    void setFloat(UniformHandle handle, float value) const;
+    void setVec3(UniformHandle handle, const glm::vec3 &value) const;
+    void setVec3(UniformHandle handle, float x, float y, float z) const;
+    void setMat3(UniformHandle handle, const glm::mat3 &mat) const;
+    void setMat4(UniformHandle handle, const glm::mat4 &mat) const;
     // --------------------------------------------------
 
     private:
-    static bool CompileShader(unsigned int shaderId, char(&infoLog)[512]);
-    static bool LinkProgram(unsigned int programID, char(&infoLog)[512]);
+    std::unordered_map<std::string, int> uniformLocations;
+    std::vector<std::string> handleNames;
+    std::vector<int> handleLocations;
+
+    // Queries every active uniform of programID and refreshes the handle table
+    void CacheUniformLocations();
+    // Submits a build if either file's version differs from fileVersionOnLoad
+    void SubmitIfChanged(const FileWatcher& watcher, ShaderCompiler& compiler);
+    int HandleLocation(UniformHandle handle) const;
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "glad.h"
+#include "glfw3.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// A program whose compile and link were issued but whose status was not read yet.
+// Reading the status is what blocks, so it is split out into FinishProgram.
+struct PendingProgram {
+    unsigned int programID = 0;
+    unsigned int vertexShaderID = 0;
+    unsigned int fragmentShaderID = 0;
+    std::string vertexFile;
+    std::string fragmentFile;
+};
+
+// Builds shader programs without stalling the frame. Uses
+// GL_KHR/ARB_parallel_shader_compile when the driver has it: compile and link are
+// issued on the main thread and polled with GL_COMPLETION_STATUS. Otherwise a
+// worker thread builds them in its own context, shared with the main one, so the
+// finished program can be used directly. If neither is available builds run
+// synchronously on Submit, which is what ReloadFromFile used to do.
+class ShaderCompiler {
+    public:
+    enum class Mode { Synchronous, Parallel, Worker };
+
+    ShaderCompiler();
+    ~ShaderCompiler();
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+    // Picks the mode; must run on the main thread with the window's context current
+    void Start(GLFWwindow* mainWindow);
+    void Stop();
+    Mode CurrentMode() const { return mode; }
+    static const char* ModeName(Mode mode);
+
+    // Starts building a program and returns a ticket for Collect (never 0)
+    uint64_t Submit(const std::string& vertexFile, const std::string& fragmentFile);
+    // Returns false while the build is still running. Once it is done, returns
+    // true exactly once: programID is the new program on success and 0 on
+    // failure (errors are already printed).
+    bool Collect(uint64_t ticket, unsigned int& programID);
+
+    // Reads the sources, creates the objects and issues compile + link, without
+    // querying any status. Fails (creating nothing) if a file can't be read.
+    static bool BeginProgram(const std::string& vertexFile, const std::string& fragmentFile, PendingProgram& pending);
+    // True when FinishProgram would not block (needs the extension)
+    static bool ProgramReady(const PendingProgram& pending);
+    // Reads compile/link status, prints errors and deletes the shader objects.
+    // The program is kept even if linking failed; the caller decides what to do.
+    static bool FinishProgram(PendingProgram& pending);
+
+    private:
+    struct Job {
+        uint64_t ticket;
+        PendingProgram pending;
+    };
+    struct Result {
+        unsigned int programID;
+        bool success;
+    };
+
+    Mode mode;
+    uint64_t nextTicket;
+
+    // Parallel: builds in flight, polled from Collect
+    std::unordered_map<uint64_t, PendingProgram> inFlight;
+
+    // Worker: hidden window sharing objects with the main context
+    GLFWwindow* workerWindow;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> jobs;
+    bool stopping;
+
+    // Finished builds of every mode (guarded by mutex for the worker)
+    std::unordered_map<uint64_t, Result> results;
+
+    void WorkerLoop();
+    static bool HasExtension(const char* name);
+};
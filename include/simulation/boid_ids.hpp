@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// IDs estáveis dos boids. O armazenamento SoA é compacto (remoção troca o último
+// boid para o buraco), então o índice de um boid muda; o ID não muda enquanto ele
+// existir. IDs liberados são reaproveitados.
+class BoidIdTable {
+    public:
+    static const uint32_t INVALID_ID = 0xffffffffu;
+
+    void Reserve(size_t count);
+    void Clear();
+
+    size_t Size() const { return slotToId.size(); }
+    // Novo ID para o boid acrescentado no fim (índice Size())
+    uint32_t Append();
+    // Espelha FlockSoA::SwapRemove(slot)
+    void SwapRemove(size_t slot);
+    void PopBack();
+
+    uint32_t IdAt(size_t slot) const { return slotToId[slot]; }
+    // Índice atual do boid ou -1 se o ID não existe
+    long long SlotOf(uint32_t id) const;
+
+    // Estado cru, para salvar e restaurar a tabela exatamente (snapshots)
+    const std::vector<uint32_t>& SlotIds() const { return slotToId; }
+    const std::vector<uint32_t>& FreeIds() const { return freeIds; }
+    uint32_t IdLimit() const { return (uint32_t)idToSlot.size(); }
+    // Reconstrói a tabela; false (sem alterar nada) se os IDs forem inconsistentes
+    bool Restore(const uint32_t* slotIds, size_t count, const uint32_t* freeIdList, size_t freeCount, uint32_t idLimit);
+
+    private:
+    std::vector<uint32_t> slotToId;
+    std::vector<int> idToSlot;
+    std::vector<uint32_t> freeIds;
+};
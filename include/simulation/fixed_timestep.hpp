@@ -0,0 +1,25 @@
+#pragma once
+
+// Acumulador de passo fixo: converte o tempo variável de cada frame em 0..k
+// passos de simulação de duração constante.
+// O resto que sobra no acumulador vira o fator de interpolação do render.
+class FixedTimestep {
+    public:
+    float stepHz;
+    // Limite de passos por frame (proteção contra a "espiral da morte")
+    int maxSubsteps;
+    // Passos descartados pelo limite desde o início
+    long long droppedSteps;
+
+    FixedTimestep(float hz = 60.0f, int maxSubsteps = 5);
+
+    float StepSeconds() const { return 1.0f / stepHz; }
+    // Soma o tempo do frame e retorna quantos passos devem ser simulados agora
+    int Advance(double frameSeconds);
+    // Fração [0, 1) do próximo passo já decorrida, para interpolar estado anterior/atual
+    float Alpha() const;
+    void Reset() { accumulator = 0.0; }
+
+    private:
+    double accumulator;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "simulation/flock_soa.hpp"
+
+// Par de buffers de estado do bando: um passo lê somente de Read() e escreve
+// somente em Write(); Swap() ao fim do passo torna o resultado o novo estado.
+// Como nenhum boid lê o que outro já escreveu no mesmo passo, caminhos serial,
+// paralelo ou vetorizado produzem exatamente o mesmo resultado.
+class FlockDoubleBuffer {
+    public:
+    FlockDoubleBuffer();
+
+    // Estado atual (o que é desenhado e o que entradas/HUD modificam)
+    FlockSoA& Read() { return buffers[readIndex]; }
+    const FlockSoA& Read() const { return buffers[readIndex]; }
+    // Destino do passo em andamento
+    FlockSoA& Write() { return buffers[1 - readIndex]; }
+    // Entre passos, o buffer de escrita guarda o estado anterior ao último Swap()
+    const FlockSoA& Previous() const { return buffers[1 - readIndex]; }
+
+    // Ajusta o buffer de escrita ao tamanho atual antes de um passo
+    void BeginStep();
+    // Publica o buffer de escrita como novo estado
+    void Swap();
+
+    private:
+    FlockSoA buffers[2];
+    int readIndex;
+};
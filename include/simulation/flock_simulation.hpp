@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "simulation/boid_ids.hpp"
+#include "simulation/flock_soa.hpp"
+#include "simulation/flock_spawn.hpp"
+#include "simulation/flock_double_buffer.hpp"
+#include "simulation/sim_command.hpp"
+#include "simulation/spatial_grid.hpp"
+#include "simulation/steering_kernel.hpp"
+#include "utils/profiler.hpp"
+#include "utils/random.hpp"
+#include "utils/thread_pool.hpp"
+
+class InputLog;
+class TrajectoryRecorder;
+
+// ---  OBSTÁCULO
+const float TOWER_RADIUS = 15.0f;
+const float TOWER_HEIGHT = 80.0f;
+const float GROUND_AVOID_HEIGHT = 5.0f;
+const float OBSTACLE_AVOID_RADIUS = TOWER_RADIUS + 2.0f;
+// ------------------------------------------
+
+// --- TUNING: BOIDS ÁGEIS ---
+const float PERCEPTION_RADIUS = 12.0f;
+const float SEPARATION_RADIUS = 4.0f;
+const float MAX_SPEED = 10.0f;
+const float MIN_SPEED = 4.0f;
+const float MAX_FORCE = 2.0f;
+
+// PESOS
+const float WEIGHT_SEPARATION = 5.0f;
+const float WEIGHT_ALIGNMENT  = 1.5f;
+const float WEIGHT_COHESION   = 1.5f;
+const float WEIGHT_GOAL       = 5.0f;
+const float WEIGHT_AVOID_FLOOR= 10.0f;
+// NOVO: Peso da força de desvio (alta prioridade)
+const float WEIGHT_AVOID_OBSTACLE = 15.0f;
+
+// --- Parâmetros do líder ---
+const float LEADER_THRUST = 80.0f;
+const float LEADER_MAX_SPEED = 9.0f;
+const float LEADER_DAMPING = 0.96f;
+
+// --- Câmera ---
+const float CAMERA_SMOOTH_SPEED = 2.0f;
+
+// Boid isolado: usado para o líder e para criar novos boids antes de irem para o SoA
+struct Boid {
+    glm::vec3 position;
+    glm::vec3 velocity;
+    glm::vec3 acceleration;
+    glm::vec3 forwardDirection;
+    float wingAngle;
+    float wingSpeed;
+
+    // Direção, velocidade e fase das asas sorteadas de 'rng'
+    Boid(glm::vec3 startPos, Random& rng);
+    // Boid parado na origem, sem sorteio (valor inicial de cópias como os snapshots)
+    Boid();
+};
+
+// Tempos de parede do último Step em milissegundos, medidos na thread que chamou Step
+struct StepTimings {
+    float leader = 0.0f;
+    float neighborSearch = 0.0f; // montagem da grade + somas dos vizinhos
+    float integration = 0.0f;    // forças, integração e média do bando
+    float total = 0.0f;
+};
+
+// Simulação completa do bando (líder, boids e alvo suavizado da câmera), sem
+// nenhuma dependência de janela ou OpenGL: usada pelo GameWindow e pelo boids-headless
+class FlockSimulation {
+    public:
+    // Gerador da simulação (stream 0 da semente): todo sorteio da simulação passa por
+    // ele ou por Stream(), então a mesma semente reproduz a execução bit a bit.
+    // Declarado antes do líder, que é sorteado no construtor.
+    Random rng;
+    uint64_t seed;
+    Boid leader;
+    FlockDoubleBuffer state;
+    glm::vec3 leaderInputDirection;
+
+    // Alvos da Câmera (Real vs Suave)
+    glm::vec3 flockCenter;
+    glm::vec3 flockAverageVelocity;
+    glm::vec3 smoothFlockCenter;
+    glm::vec3 smoothFlockVelocity;
+
+    // Estado antes do último Step, para o render interpolar entre passos fixos
+    Boid previousLeader;
+    glm::vec3 previousSmoothFlockCenter;
+    glm::vec3 previousSmoothFlockVelocity;
+
+    // Busca de vizinhos: grade espacial (O(N)) ou laço força-bruta (O(N²)) para comparação
+    bool useSpatialGrid;
+    // Threads usadas no passo (inclui a thread que chama Step)
+    int threadCount;
+    // Laço de vizinhos: escalar (referência bit a bit) ou SIMD; padrão = melhor da CPU
+    SteeringKernel steeringKernel;
+    StepTimings lastStepTimings;
+    // Se não for nulo, recebe uma cópia do bando no fim de cada Step (fora de lastStepTimings)
+    TrajectoryRecorder* recorder;
+    // Se não for nulo, registra todo comando de Apply e todo Step (input_log.hpp)
+    InputLog* inputLog;
+
+    FlockSimulation();
+
+    // Reinicia o gerador principal com uma nova semente
+    void Seed(uint64_t newSeed);
+    // Iguala o estado "anterior" (previousLeader, alvos suavizados) ao atual. Quem move
+    // o líder ou a câmera fora de Step chama isto, senão os primeiros frames interpolam
+    // a partir da posição antiga.
+    void ResetInterpolation();
+    // Stream independente da mesma semente, para sorteios em paralelo
+    // (um por thread ou por bloco de trabalho, sem compartilhar estado)
+    Random Stream(uint64_t index) const { return Random(seed, index + 1); }
+
+    // Estado atual do bando. Adicionar/remover boids deve passar pelos métodos
+    // abaixo, que mantêm os IDs estáveis e o buffer anterior alinhados.
+    FlockSoA& Flock() { return state.Read(); }
+    const FlockSoA& Flock() const { return state.Read(); }
+    // Bando antes do último Step; os índices [0, min(tamanhos)) são os mesmos boids
+    const FlockSoA& PreviousFlock() const { return state.Previous(); }
+
+    // Copia um boid recém-criado para o armazenamento SoA do bando
+    void AddBoid(const Boid& b);
+    // Remove o último boid; retorna false se o bando já estava vazio
+    bool RemoveBoid();
+
+    // --- Pool de boids ---
+    // Os arrays são pré-alocados (e crescem no máximo uma vez por Spawn), então criar
+    // milhares de boids não realoca vetor a vetor no meio de um frame
+    size_t Capacity() const { return Flock().px.capacity(); }
+    void Reserve(size_t capacity);
+    void Clear();
+    // Cria params.count boids na forma pedida; retorna o índice do primeiro.
+    // Preenche em paralelo, com um stream do gerador por bloco (mesmo resultado com qualquer threadCount)
+    size_t Spawn(const SpawnParams& params);
+    // Remove 'count' boids sorteados (troca com o último); retorna quantos saíram
+    size_t Despawn(size_t count);
+    bool DespawnId(uint32_t id);
+    // Cria (ao redor do líder) ou remove boids até o bando ter 'count'
+    void SetTargetCount(size_t count, SpawnShape shape = SpawnShape::Sphere);
+
+    uint32_t IdAt(size_t slot) const { return ids.IdAt(slot); }
+    // ID de cada slot, alinhado com os arrays de Flock()
+    const std::vector<uint32_t>& SlotIds() const { return ids.SlotIds(); }
+    // Índice atual do boid com esse ID, ou -1
+    long long SlotOf(uint32_t id) const { return ids.SlotOf(id); }
+    // Aplica um comando de entrada (direção do líder, adicionar/remover, opções do passo).
+    // Retorna false para comandos que não são do estado da simulação (pausa, ritmo...),
+    // que ainda assim passam por aqui para ficarem no log de entrada
+    bool Apply(const SimCommand& command);
+
+    void Step(float dt, bool debugPrint = false);
+
+    // Hash FNV-1a do estado (bits exatos de posições e velocidades, bando e líder)
+    unsigned long long Checksum() const;
+
+    // --- Snapshots em disco (formato em flock_snapshot_file.hpp) ---
+    // Estado completo: bando, IDs, líder, alvos da câmera e gerador. Carregar e seguir
+    // rodando dá o mesmo resultado, bit a bit, que continuar a execução que salvou.
+    // Configurações do passo (threads, kernel, grade) não fazem parte do snapshot.
+    // Grava o arquivo inteiro com uma única escrita; false (com mensagem) em erro
+    bool SaveSnapshotFile(const std::string& path) const;
+    // Mapeia o arquivo e copia os arrays direto para o SoA; em erro nada é alterado
+    bool LoadSnapshotFile(const std::string& path);
+    // O mesmo formato em memória, para embutir num outro arquivo (o log de entrada).
+    // 'data' precisa estar alinhado a SNAPSHOT_SECTION_ALIGNMENT; 'source' só aparece nos erros
+    void SaveSnapshot(std::vector<unsigned char>& buffer) const;
+    bool LoadSnapshot(const unsigned char* data, size_t size, const std::string& source);
+
+    // --- Estágios da fase 2 de um boid ---
+    // IntegrateBoid encadeia os três; ficam públicos para o boids-bench medir cada um
+    // isoladamente sobre um bando congelado.
+    // Forças de bando (somas dos vizinhos) e de seguir o líder, já ponderadas
+    glm::vec3 FlockingForce(const glm::vec3& position, const glm::vec3& velocity, const NeighborSums& sums) const;
+    // Soma à aceleração o desvio do chão e da torre
+    void AddObstacleForces(const glm::vec3& position, const glm::vec3& velocity, glm::vec3& acceleration) const;
+    // Aplica a aceleração e escreve o boid bi em 'next' (inclui a correção de colisão com a torre)
+    void IntegrateMotion(size_t bi, const FlockSoA& prev, FlockSoA& next, float dt, glm::vec3 acceleration) const;
+
+    private:
+    SpatialGrid grid;
+    ThreadPool pool;
+    std::vector<NeighborSums> neighborSums;
+    SteeringKernelFn gatherKernel;
+    BoidIdTable ids;
+
+    void EnsureCapacity(size_t count);
+    void RemoveSlot(size_t slot);
+
+    void StepLeader(float dt);
+    // Passo de um boid: lê apenas o estado anterior 'prev' e escreve só o índice bi de
+    // 'next' (ou de neighborSums), então o resultado não depende da ordem nem de quantas
+    // threads atualizam o bando
+    void GatherNeighbors(size_t bi, const FlockSoA& prev, std::vector<int>& candidates, NeighborSums& sums) const;
+    void IntegrateBoid(size_t bi, const FlockSoA& prev, FlockSoA& next, float dt, const NeighborSums& sums) const;
+};
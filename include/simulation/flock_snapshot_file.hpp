@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Formato binário de um FlockSimulation salvo em disco (FlockSimulation::SaveSnapshotFile).
+//
+// [SnapshotFileHeader][seção 0][seção 1]...: cada seção é um array cru na ordem da
+// memória, começando num múltiplo de SNAPSHOT_SECTION_ALIGNMENT. Tudo fica em ordem de
+// bytes nativa, então carregar é mapear o arquivo, checar o cabeçalho e copiar cada
+// array direto para o vetor correspondente do SoA, sem interpretar nada.
+// Mudanças de layout incrementam SNAPSHOT_FILE_VERSION; versões diferentes são recusadas.
+
+const char SNAPSHOT_FILE_MAGIC[8] = { 'B', 'O', 'I', 'D', 'S', 'N', 'A', 'P' };
+const uint32_t SNAPSHOT_FILE_VERSION = 1;
+// Lido como 0x04030201 numa máquina de ordem de bytes oposta à que gravou
+const uint32_t SNAPSHOT_ENDIAN_TAG = 0x01020304u;
+const size_t SNAPSHOT_SECTION_ALIGNMENT = 64;
+
+// Seções de arrays, todas com boidCount elementos exceto FreeIds (freeIdCount)
+enum SnapshotSection {
+    SNAPSHOT_PX, SNAPSHOT_PY, SNAPSHOT_PZ,
+    SNAPSHOT_VX, SNAPSHOT_VY, SNAPSHOT_VZ,
+    SNAPSHOT_FX, SNAPSHOT_FY, SNAPSHOT_FZ,
+    SNAPSHOT_WING_ANGLE, SNAPSHOT_WING_SPEED,
+    SNAPSHOT_SLOT_IDS,   // uint32: ID estável de cada boid
+    SNAPSHOT_FREE_IDS,   // uint32: IDs liberados, na ordem em que serão reaproveitados
+    SNAPSHOT_SECTION_COUNT
+};
+
+struct SnapshotVec3 {
+    float x, y, z;
+};
+
+struct SnapshotBoid {
+    SnapshotVec3 position;
+    SnapshotVec3 velocity;
+    SnapshotVec3 acceleration;
+    SnapshotVec3 forwardDirection;
+    float wingAngle;
+    float wingSpeed;
+};
+
+struct SnapshotFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;          // sizeof(SnapshotFileHeader) de quem gravou
+    uint32_t endianTag;
+    uint32_t idLimit;              // maior ID já emitido + 1
+    uint64_t fileBytes;
+    uint64_t boidCount;
+    uint64_t freeIdCount;
+
+    // Gerador da simulação
+    uint64_t seed;
+    uint64_t rngState[4];
+
+    // Líder, entrada e alvos da câmera (atuais e os do passo anterior, para interpolar)
+    SnapshotBoid leader;
+    SnapshotBoid previousLeader;
+    SnapshotVec3 leaderInputDirection;
+    SnapshotVec3 flockCenter;
+    SnapshotVec3 flockAverageVelocity;
+    SnapshotVec3 smoothFlockCenter;
+    SnapshotVec3 smoothFlockVelocity;
+    SnapshotVec3 previousSmoothFlockCenter;
+    SnapshotVec3 previousSmoothFlockVelocity;
+    uint32_t reserved;
+
+    // Início de cada seção, em bytes desde o começo do arquivo
+    uint64_t sectionOffset[SNAPSHOT_SECTION_COUNT];
+};
+
+static_assert(std::is_trivially_copyable<SnapshotFileHeader>::value, "the header is written and mapped as raw bytes");
+static_assert(sizeof(SnapshotBoid) == 56, "SnapshotBoid layout changed: bump SNAPSHOT_FILE_VERSION");
+static_assert(sizeof(SnapshotFileHeader) % 8 == 0, "sections after the header must stay 8-byte aligned");
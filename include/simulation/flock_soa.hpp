@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Armazenamento do bando em estrutura de arrays (SoA).
+// O laço de vizinhos lê apenas posição e velocidade, então cada componente
+// fica em um array contíguo próprio; campos frios (direção, asas) ficam à parte.
+class FlockSoA {
+    public:
+    std::vector<float> px, py, pz;   // posição
+    std::vector<float> vx, vy, vz;   // velocidade
+    std::vector<float> fx, fy, fz;   // direção de voo (forwardDirection)
+    std::vector<float> wingAngle;
+    std::vector<float> wingSpeed;
+
+    FlockSoA();
+
+    size_t Size() const { return px.size(); }
+    bool Empty() const { return px.empty(); }
+    void Reserve(size_t count);
+    void Resize(size_t count);
+    void Clear();
+
+    // Adiciona um boid no fim e retorna seu índice
+    size_t Add(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& forward,
+               float angle, float speed);
+    void PopBack();
+    // Remove o boid i movendo o último para o lugar dele (O(1), sem deslocar o resto)
+    void SwapRemove(size_t i);
+
+    glm::vec3 Position(size_t i) const { return glm::vec3(px[i], py[i], pz[i]); }
+    glm::vec3 Velocity(size_t i) const { return glm::vec3(vx[i], vy[i], vz[i]); }
+    glm::vec3 Forward(size_t i) const { return glm::vec3(fx[i], fy[i], fz[i]); }
+
+    void SetPosition(size_t i, const glm::vec3& p) { px[i] = p.x; py[i] = p.y; pz[i] = p.z; }
+    void SetVelocity(size_t i, const glm::vec3& v) { vx[i] = v.x; vy[i] = v.y; vz[i] = v.z; }
+    void SetForward(size_t i, const glm::vec3& f) { fx[i] = f.x; fy[i] = f.y; fz[i] = f.z; }
+};
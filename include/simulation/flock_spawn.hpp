@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "utils/random.hpp"
+
+// Formas para criar muitos boids de uma vez
+enum class SpawnShape {
+    Sphere, // bola cheia de raio 'radius'
+    Box,    // cubo de meia-aresta 'radius'
+    Ring    // anel horizontal entre 0.8 e 1.0 de 'radius', com pouca variação de altura
+};
+
+struct SpawnParams {
+    SpawnShape shape = SpawnShape::Sphere;
+    glm::vec3 center = glm::vec3(0.0f);
+    size_t count = 0;
+    // <= 0: escolhe o tamanho pela densidade de ~1 boid por SEPARATION_RADIUS³
+    float radius = 0.0f;
+};
+
+// Raio que dá ~1 boid por SEPARATION_RADIUS³ para 'count' boids na forma
+float AutoSpawnRadius(SpawnShape shape, size_t count);
+// Deslocamento uniforme em relação ao centro da forma
+glm::vec3 SampleSpawnOffset(SpawnShape shape, float radius, Random& rng);
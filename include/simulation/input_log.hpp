@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "simulation/sim_command.hpp"
+#include "utils/mapped_file.hpp"
+
+class FlockSimulation;
+
+// Log de entrada de uma execução: o estado inicial e, na ordem em que aconteceram,
+// todo SimCommand aplicado ao FlockSimulation e todo Step (com o dt usado). Como o
+// passo é determinístico, reaplicar o log a partir do mesmo estado refaz a execução
+// bit a bit, com qualquer número de threads; checksums gravados no caminho apontam
+// o passo em que uma reprodução divergiu.
+//
+// Arquivo: [InputLogHeader][snapshot inicial (formato de flock_snapshot_file.hpp)][registros]
+// Comandos de controle do laço (pausa, passo único, ritmo) também ficam no log, mas
+// só como registro: o efeito deles já aparece na sequência de passos e de dt.
+const char INPUT_LOG_MAGIC[8] = { 'B', 'O', 'I', 'D', 'I', 'N', 'P', 'T' };
+const uint32_t INPUT_LOG_VERSION = 1;
+const uint32_t INPUT_LOG_ENDIAN_TAG = 0x01020304u;
+// Limites de um registro aceito na reprodução; fora deles o log está corrompido
+const int INPUT_LOG_MAX_THREADS = 1024;
+const float INPUT_LOG_MAX_BOIDS = 16777216.0f; // 2^24: maior inteiro exato num float
+
+enum InputLogRecordKind : uint32_t {
+    INPUT_LOG_COMMAND = 0,  // type, shape, value, vector de um SimCommand
+    INPUT_LOG_STEPS = 1,    // 'count' passos seguidos com dt = value
+    INPUT_LOG_CHECKSUM = 2  // FlockSimulation::Checksum() neste ponto do log
+};
+
+struct InputLogRecord {
+    uint32_t kind;
+    uint32_t type;
+    uint32_t shape;
+    uint32_t count;
+    float value;
+    float vector[3];
+    uint64_t checksum;
+};
+
+struct InputLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t endianTag;
+    // Configuração do passo no início (não faz parte do snapshot); mudanças posteriores
+    // chegam como comandos
+    uint32_t steeringKernel;
+    uint32_t useSpatialGrid;
+    uint32_t threadCount;
+    uint64_t snapshotOffset;
+    uint64_t snapshotBytes;
+    uint64_t recordOffset;
+    uint64_t recordCount;
+    uint64_t stepCount;
+    uint64_t finalChecksum;
+};
+
+static_assert(std::is_trivially_copyable<InputLogHeader>::value, "the header is written and mapped as raw bytes");
+static_assert(sizeof(InputLogRecord) == 40, "InputLogRecord layout changed: bump INPUT_LOG_VERSION");
+
+// Grava o log. Record e RecordStep são chamados pelo próprio FlockSimulation (Apply e
+// Step) quando FlockSimulation::inputLog aponta para cá, então só rodam na thread dona
+// da simulação; Start e Stop precisam dela parada.
+class InputLog {
+    public:
+    // Passos entre checksums intermediários (cada um percorre o bando inteiro uma vez)
+    uint32_t checksumInterval = 600;
+
+    InputLog();
+
+    // Guarda o estado atual de 'sim' como ponto de partida
+    bool Start(const std::string& path, const FlockSimulation& sim);
+    // Acrescenta o checksum final e grava o arquivo (temporário + rename, como os snapshots)
+    bool Stop();
+    bool Recording() const { return sim != nullptr; }
+
+    void Record(const SimCommand& command);
+    void RecordStep(float dt);
+
+    uint64_t StepCount() const { return stepCount.load(std::memory_order_relaxed); }
+
+    private:
+    std::string path;
+    const FlockSimulation* sim;
+    InputLogHeader header;
+    std::vector<unsigned char> snapshot;
+    std::vector<InputLogRecord> records;
+    std::atomic<uint64_t> stepCount;
+    // Reenviar a mesma direção do líder não muda nada; não precisa de um registro por frame
+    float lastLeaderDirection[3];
+
+    void AddChecksum();
+};
+
+struct InputReplayOptions {
+    // > 0: roda com esse número de threads e ignora SetThreadCount do log (o resultado
+    // é o mesmo; só o tempo muda). 0: segue o log.
+    int threads = 0;
+    // Imprime cada checksum intermediário conferido
+    bool verbose = false;
+};
+
+struct InputReplayResult {
+    uint64_t steps = 0;
+    uint64_t commands = 0;
+    uint64_t checksumsVerified = 0;
+    bool diverged = false;
+    uint64_t divergedAtStep = 0;
+    // Só o tempo dentro de Step
+    double stepSeconds = 0.0;
+    double slowestStepMilliseconds = 0.0;
+    uint64_t slowestStep = 0;
+};
+
+// Reprodução de um log: Open carrega o estado inicial e a configuração do passo em
+// 'sim'; Run reaplica comandos e passos na mesma ordem, conferindo os checksums.
+class InputReplay {
+    public:
+    bool Open(const std::string& path, FlockSimulation& sim, const InputReplayOptions& options = InputReplayOptions());
+    // false se um registro for inválido; uma divergência para a reprodução e fica em 'result'
+    bool Run(FlockSimulation& sim, InputReplayResult& result);
+
+    uint64_t StepCount() const { return header.stepCount; }
+    unsigned long long FinalChecksum() const { return header.finalChecksum; }
+
+    private:
+    std::string path;
+    MappedFile file;
+    InputLogHeader header;
+    InputReplayOptions options;
+};
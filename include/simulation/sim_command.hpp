@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "simulation/flock_spawn.hpp"
+
+// Comando de entrada para a simulação. Com a simulação na própria thread, o
+// ProcessInput não toca no FlockSimulation: enfileira comandos que a thread da
+// simulação aplica antes do próximo passo, na ordem em que chegaram.
+struct SimCommand {
+    enum Type {
+        // Estado da simulação (FlockSimulation::Apply)
+        SetLeaderDirection, // vector = direção de entrada do líder
+        AddBoid,            // perto do líder, sorteado pelo gerador da simulação
+        RemoveBoid,
+        SpawnBoids,         // value = quantidade, vector = centro relativo ao líder, shape
+        DespawnBoids,       // value = quantidade (boids sorteados)
+        SetTargetCount,     // value = tamanho do bando; cria com 'shape' ao redor do líder
+        SetSpatialGrid,     // value != 0 liga a grade espacial
+        SetThreadCount,     // value = threads do passo
+        SetSteeringKernel,  // value = SteeringKernel
+        // Controle do laço (SimulationThread)
+        SetPaused,          // value != 0 pausa
+        SingleStep,         // um passo enquanto pausado
+        SetStepHz,          // value = passos por segundo
+        SetDebugPrint       // value != 0 imprime o passo único
+    };
+
+    Type type;
+    glm::vec3 vector;
+    float value;
+    SpawnShape shape;
+
+    SimCommand(Type t, glm::vec3 v = glm::vec3(0.0f), float val = 0.0f, SpawnShape s = SpawnShape::Sphere)
+        : type(t), vector(v), value(val), shape(s) {}
+    SimCommand(Type t, float val, SpawnShape s = SpawnShape::Sphere) : type(t), vector(0.0f), value(val), shape(s) {}
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "simulation/flock_simulation.hpp"
+#include "simulation/fixed_timestep.hpp"
+#include "simulation/sim_command.hpp"
+#include "utils/triple_buffer.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Cópia imutável do que o render precisa depois de um passo: estado anterior e
+// atual (para interpolar), líder e alvo suavizado da câmera
+struct FlockSnapshot {
+    FlockSoA previousFlock;
+    FlockSoA flock;
+    Boid previousLeader;
+    Boid leader;
+    glm::vec3 previousSmoothFlockCenter;
+    glm::vec3 smoothFlockCenter;
+    glm::vec3 previousSmoothFlockVelocity;
+    glm::vec3 smoothFlockVelocity;
+
+    // Instante dos passos publicados (SimulationThread::Now) e duração do passo, para o alpha do render
+    double publishedAt;
+    float stepSeconds;
+    unsigned long long stepIndex;
+    long long droppedSteps;
+    float stepMilliseconds;
+    StepTimings timings;
+
+    FlockSnapshot();
+    void Capture(const FlockSimulation& sim);
+};
+
+// Roda FlockSimulation::Step numa thread própria, no seu próprio ritmo.
+// Entrada: fila de SimCommand (Push). Saída: snapshots num buffer triplo sem
+// travas, então nem um swap lento (vsync) atrasa a simulação nem um passo
+// pesado atrasa o render.
+// Enquanto está rodando, a thread é a única dona do FlockSimulation.
+class SimulationThread {
+    public:
+    explicit SimulationThread(FlockSimulation& sim);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void Start(float stepHz, bool paused, bool debugPrint);
+    // Aplica os comandos pendentes e devolve a posse do FlockSimulation a quem chamou
+    void Stop();
+    bool Running() const { return thread.joinable(); }
+
+    void Push(const SimCommand& command);
+    // Snapshot mais recente; válido até a próxima chamada (lado do render)
+    const FlockSnapshot& Latest() { return snapshots.Acquire(); }
+
+    // Relógio monotônico em segundos, o mesmo usado em FlockSnapshot::publishedAt
+    static double Now();
+
+    private:
+    FlockSimulation& sim;
+    std::thread thread;
+    std::atomic<bool> running;
+
+    std::mutex commandMutex;
+    std::vector<SimCommand> pending;
+    std::vector<SimCommand> applying; // só a thread da simulação
+
+    TripleBuffer<FlockSnapshot> snapshots;
+
+    // Estado do laço, só a thread da simulação
+    FixedTimestep clock;
+    bool paused;
+    bool debugPrint;
+    int stepsRequested;
+    unsigned long long stepIndex;
+    float lastStepMilliseconds;
+    // Instante do último lote de passos: um snapshot republicado sem passo (comando
+    // aplicado com a simulação pausada ou entre passos) não reinicia a interpolação
+    double steppedAt;
+
+    void Loop();
+    // true se algum comando mudou o estado da simulação (FlockSimulation::Apply aceitou)
+    bool ApplyCommands();
+    void Publish();
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Grade uniforme com hash espacial para busca de vizinhos do bando.
+// Cada célula tem aresta igual ao raio de percepção, então todo vizinho dentro
+// do raio está na célula do boid ou em uma das 26 células adjacentes.
+// A grade é reconstruída a cada passo a partir do snapshot do bando, em layout
+// compacto (ordenação por contagem): ids de cada bucket ficam contíguos e crescentes.
+class SpatialGrid {
+    public:
+    SpatialGrid();
+
+    // Reconstrói a grade com as posições (x[i], y[i], z[i]) dos boids 0..n-1
+    void Build(float cellSize, const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z);
+    // Preenche 'out' com os candidatos das 27 células ao redor de 'position',
+    // em ordem crescente de id e sem repetições
+    void Query(const glm::vec3& position, std::vector<int>& out) const;
+
+    private:
+    float cellSize;
+    float invCellSize;
+    size_t bucketMask;
+    std::vector<int> bucketStart;   // início de cada bucket em 'entries' (tamanho buckets + 1)
+    std::vector<int> entries;       // ids ordenados por bucket, crescentes dentro de cada um
+    std::vector<size_t> entryBucket;
+
+    size_t BucketIndex(int cx, int cy, int cz) const;
+    size_t BucketFor(const glm::vec3& position) const;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+#include "simulation/flock_soa.hpp"
+
+// Somas dos vizinhos de um boid (fase 1 do passo), consumidas pela integração (fase 2)
+struct NeighborSums {
+    glm::vec3 cohesion;
+    glm::vec3 alignment;
+    glm::vec3 separation;
+    int count;
+};
+
+// Implementações do laço de vizinhos. Scalar é a referência (mesma aritmética do
+// código original, bit a bit); as versões SIMD testam 8 candidatos por iteração com
+// distância ao quadrado e acumulação mascarada, e diferem da referência só por
+// arredondamento (ordem de soma, sqrt só para separação).
+enum class SteeringKernel {
+    Scalar,
+    SSE4,
+    AVX2
+};
+
+// Soma as contribuições dos 'count' candidatos (índices em 'prev') para o boid 'self';
+// o próprio boid pode aparecer na lista e é ignorado
+typedef void (*SteeringKernelFn)(const FlockSoA& prev, size_t self, const int* candidates, size_t count,
+                                 NeighborSums& sums);
+
+// Melhor kernel suportado pela CPU atual (detectado em tempo de execução)
+SteeringKernel BestSteeringKernel();
+bool SteeringKernelSupported(SteeringKernel kernel);
+// Função do kernel; cai para Scalar se o pedido não for suportado
+SteeringKernelFn SelectSteeringKernel(SteeringKernel kernel);
+const char* SteeringKernelName(SteeringKernel kernel);
+
+void GatherNeighborsScalar(const FlockSoA& prev, size_t self, const int* candidates, size_t count, NeighborSums& sums);
+#if BOIDS_X86_KERNELS
+void GatherNeighborsSSE4(const FlockSoA& prev, size_t self, const int* candidates, size_t count, NeighborSums& sums);
+void GatherNeighborsAVX2(const FlockSoA& prev, size_t self, const int* candidates, size_t count, NeighborSums& sums);
+#endif
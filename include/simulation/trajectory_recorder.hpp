@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/mapped_file.hpp"
+
+class FlockSimulation;
+
+// Gravação das trajetórias do bando (posição e velocidade de todo boid, passo a passo).
+//
+// Arquivo: [TrajectoryFileHeader][bloco][bloco]...[índice][TrajectoryFileTrailer]
+// Cada bloco guarda até blockFrames frames e começa por um quadro-chave, então pode
+// ser decodificado sozinho; o índice no fim (frame inicial e posição de cada bloco)
+// permite saltar direto para qualquer frame. Sem índice (gravação interrompida) o
+// leitor percorre os cabeçalhos dos blocos.
+//
+// Cada frame guarda a caixa envolvente das posições e a das velocidades; cada
+// componente vira um inteiro de 16 bits relativo à caixa (erro máximo de meio passo:
+// tamanho da caixa / 131070) e é gravado como a diferença para uma previsão feita com
+// o mesmo boid nos frames anteriores (TrajectoryPredictor), em zigzag, empacotada em
+// grupos de 64 com o número de bits do maior resíduo do grupo (boids parados ou
+// componentes que não mudaram custam um byte por grupo).
+const char TRAJECTORY_FILE_MAGIC[8] = { 'B', 'O', 'I', 'D', 'T', 'R', 'A', 'J' };
+const char TRAJECTORY_INDEX_MAGIC[8] = { 'T', 'R', 'A', 'J', 'I', 'N', 'D', 'X' };
+const uint32_t TRAJECTORY_FILE_VERSION = 1;
+const uint32_t TRAJECTORY_ENDIAN_TAG = 0x01020304u;
+const int TRAJECTORY_QUANTIZATION_BITS = 16;
+
+// Previsão usada para uma componente (todos os boids) de um frame. Quadros-chave usam
+// NONE; os demais escolhem, frame a frame, o que der menos bytes: velocidades mudam
+// pouco entre passos (PREVIOUS), posições andam quase em linha reta (LINEAR).
+enum TrajectoryPredictor : uint8_t {
+    TRAJECTORY_PREDICT_NONE = 0,     // valor quantizado direto
+    TRAJECTORY_PREDICT_PREVIOUS = 1, // valor do frame anterior
+    TRAJECTORY_PREDICT_LINEAR = 2    // extrapola os dois frames anteriores: 2*q[t-1] - q[t-2]
+};
+
+struct TrajectoryFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t endianTag;
+    uint32_t quantizationBits;
+    uint32_t blockFrames;
+    uint32_t reserved;
+};
+
+struct TrajectoryBlockHeader {
+    uint64_t firstFrame;
+    uint32_t frameCount;
+    uint32_t reserved;
+    uint64_t payloadBytes;   // frames codificados que vêm logo depois
+};
+
+struct TrajectoryIndexEntry {
+    uint64_t firstFrame;
+    uint64_t fileOffset;     // do TrajectoryBlockHeader
+    uint32_t frameCount;
+    uint32_t reserved;
+};
+
+struct TrajectoryFileTrailer {
+    uint64_t indexOffset;
+    uint64_t blockCount;
+    uint64_t frameCount;
+    char magic[8];
+};
+
+// Um frame decodificado (ou capturado): arrays paralelos por boid, na ordem dos slots
+struct TrajectoryFrame {
+    // Passos desde Start; pula números quando a fila encheu e frames foram descartados
+    uint64_t step = 0;
+    std::vector<uint32_t> ids;
+    std::vector<float> px, py, pz;
+    std::vector<float> vx, vy, vz;
+
+    size_t Size() const { return ids.size(); }
+};
+
+struct TrajectoryRecorderOptions {
+    // Frames por bloco: blocos maiores comprimem um pouco melhor, menores saltam mais rápido
+    int blockFrames = 32;
+    // Frames capturados esperando o escritor (cada um é uma cópia do bando: 2.8 MB com
+    // 100k boids); passou disso o frame é descartado (ou, com waitWhenFull, Capture
+    // espera: para execuções offline sem perda)
+    int queueFrames = 16;
+    bool waitWhenFull = false;
+};
+
+// Captura no fim de cada FlockSimulation::Step (só copia os arrays para um buffer
+// reaproveitado) e quantiza, codifica e grava numa thread própria, para que gravar
+// 100k boids não atrase o laço da simulação.
+class TrajectoryRecorder {
+    public:
+    TrajectoryRecorder();
+    ~TrajectoryRecorder();
+
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    bool Start(const std::string& path, const TrajectoryRecorderOptions& options = TrajectoryRecorderOptions());
+    // Grava o que ainda está na fila, o índice e fecha o arquivo
+    void Stop();
+    bool Recording() const { return writer.joinable(); }
+
+    // Chamado pela thread dona da simulação
+    void Capture(const FlockSimulation& sim);
+
+    uint64_t FramesCaptured() const { return framesCaptured.load(std::memory_order_relaxed); }
+    uint64_t FramesDropped() const { return framesDropped.load(std::memory_order_relaxed); }
+    uint64_t BytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+    // Bytes que os mesmos frames ocupariam como floats crus (posição, velocidade e ID)
+    uint64_t RawBytes() const { return rawBytes.load(std::memory_order_relaxed); }
+
+    private:
+    TrajectoryRecorderOptions options;
+    std::string path;
+    FILE* file;
+    std::thread writer;
+
+    std::mutex mutex;
+    std::condition_variable frameReady;
+    std::condition_variable frameFreed;
+    std::deque<TrajectoryFrame*> queue;
+    std::vector<TrajectoryFrame*> freeFrames;
+    std::vector<TrajectoryFrame*> allFrames;
+    bool stopping;
+
+    std::atomic<uint64_t> framesCaptured;
+    std::atomic<uint64_t> framesDropped;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> rawBytes;
+    // Só a thread que chama Capture
+    uint64_t nextStep;
+
+    // Só a thread do escritor
+    uint64_t nextFrame;
+    bool writeFailed;
+    // Frames seguidos com os mesmos boids até o anterior, contando o quadro-chave
+    uint32_t history;
+    std::vector<uint32_t> previousIds;
+    std::vector<uint32_t> previousQuantized[6];
+    std::vector<uint32_t> olderQuantized[6];
+    std::vector<uint32_t> currentQuantized;
+    std::vector<uint32_t> residualBuffer;
+    std::vector<uint32_t> candidateBuffer;
+    std::vector<unsigned char> block;
+    uint32_t blockFrameCount;
+    uint64_t blockFirstFrame;
+    uint64_t fileOffset;
+    std::vector<TrajectoryIndexEntry> index;
+
+    void WriterLoop();
+    void EncodeFrame(const TrajectoryFrame& frame);
+    void FlushBlock();
+    void WriteBytes(const void* data, size_t size);
+};
+
+// Leitura aleatória de uma gravação: mapeia o arquivo e decodifica só o bloco do frame pedido
+class TrajectoryReader {
+    public:
+    bool Open(const std::string& path);
+    uint64_t FrameCount() const { return frameCount; }
+    size_t BlockCount() const { return blocks.size(); }
+    // Decodifica o frame 'frame' (0 = primeiro gravado); false se não existir ou estiver corrompido
+    bool ReadFrame(uint64_t frame, TrajectoryFrame& out);
+
+    private:
+    MappedFile file;
+    std::vector<TrajectoryIndexEntry> blocks;
+    uint64_t frameCount = 0;
+
+    // Bloco atual e até onde ele já foi decodificado, para leituras sequenciais
+    // continuarem de onde pararam em vez de voltar ao quadro-chave
+    long long cachedBlock = -1;
+    const unsigned char* blockData = nullptr;
+    size_t blockBytes = 0;
+    size_t cursor = 0;
+    uint64_t decodedFrame = 0;
+    bool anyDecoded = false;
+    uint64_t step = 0;
+    float bounds[12] = {};
+    uint32_t history = 0;
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> quantized[6];
+    std::vector<uint32_t> olderQuantized[6];
+    std::vector<uint32_t> residuals;
+
+    bool LoadBlock(size_t block);
+    bool DecodeNext();
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Watches a set of files on a background thread and counts their modifications.
+// On Linux it sleeps on inotify (watching each file's directory, so editors that
+// save by renaming a new file over the old one are still seen); elsewhere, or if
+// inotify is unavailable, it stats the files every pollInterval milliseconds.
+// Readers only touch atomics and a mutex-guarded table, so checking for changes
+// every frame costs no syscalls.
+class FileWatcher {
+    public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Files must be registered before Start()
+    void Watch(const std::string& path);
+    void Start(int pollIntervalMs = 250);
+    void Stop();
+    bool Running() const { return thread.joinable(); }
+    // True while the inotify backend is active (false: polling fallback)
+    bool UsingInotify() const { return usingInotify; }
+
+    // Number of changes seen on 'path' so far (0 if never changed or not watched)
+    uint64_t Version(const std::string& path) const;
+    // Total changes over every file: compare with the last value seen to know
+    // whether anything changed at all
+    uint64_t Changes() const { return changes.load(std::memory_order_acquire); }
+
+    private:
+    struct WatchedFile {
+        std::string path;
+        std::string directory;
+        std::string name;
+        uint64_t version;
+        int watchDescriptor;   // inotify watch of 'directory' (shared by files in the same one)
+        // Polling fallback: last seen modification time and size
+        long long modTime;
+        long long size;
+    };
+
+    std::vector<WatchedFile> files;
+    mutable std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::thread thread;
+    std::atomic<uint64_t> changes;
+    bool stopping;
+    bool usingInotify;
+    int pollIntervalMs;
+    int inotifyFd;
+    int wakePipe[2];
+
+    void MarkChanged(size_t index);
+    bool StartInotify();
+    void InotifyLoop();
+    void PollLoop();
+    // Reads the current modification time/size of files[index]; false if it is missing
+    bool StatFile(size_t index, long long& modTime, long long& size) const;
+};
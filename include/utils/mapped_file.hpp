@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file mapped into memory (mmap, or MapViewOfFile on
+// Windows). Pages are faulted in on first touch, so opening is O(1) whatever the
+// file size, and the data is read straight from the page cache without a copy
+// into a separate buffer. The view stays valid until Close() or destruction.
+class MappedFile {
+    public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Fails (printing why) if the file can't be opened or mapped; empty files fail too
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return data != nullptr; }
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+    private:
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
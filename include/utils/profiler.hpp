@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+// Wall-clock stopwatch on the monotonic clock
+class Stopwatch {
+    public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+
+    void Restart() { start = std::chrono::steady_clock::now(); }
+    float Milliseconds() const {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Rolling window of the last CAPACITY samples (milliseconds) of one stage.
+// Samples are kept in a ring so the HUD can plot them without copying.
+class TimingHistory {
+    public:
+    static const size_t CAPACITY = 240;
+
+    TimingHistory();
+
+    void Add(float milliseconds);
+    void Clear();
+
+    size_t Count() const { return count; }
+    // Ring storage and the index of the oldest sample, as ImGui::PlotLines expects them
+    const float* Data() const { return samples; }
+    size_t Offset() const { return count < CAPACITY ? 0 : next; }
+
+    float Latest() const;
+    float Min() const;
+    float Max() const;
+    float Average() const;
+    // p in [0, 1]; nearest-rank percentile over the window
+    float Percentile(float p) const;
+
+    private:
+    float samples[CAPACITY];
+    size_t next;
+    size_t count;
+};
+
+// Adds the time between construction and destruction to a history
+class ScopedTimer {
+    public:
+    explicit ScopedTimer(TimingHistory& target) : history(target) {}
+    ~ScopedTimer() { history.Add(watch.Milliseconds()); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+    TimingHistory& history;
+    Stopwatch watch;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro256** generator (Blackman & Vigna), seeded through SplitMix64.
+// Each generator is a plain value owned by whoever draws from it, so there is no
+// shared global state like rand(). Independent streams come from the same seed
+// by jumping 2^128 draws ahead per stream index, which keeps per-thread or
+// per-chunk sequences disjoint and identical on every run.
+class Random {
+    public:
+    explicit Random(uint64_t seed = 1, uint64_t stream = 0);
+
+    void Seed(uint64_t seed, uint64_t stream = 0);
+
+    uint64_t Next() {
+        uint64_t result = Rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = Rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform integer in [0, bound) (Lemire's multiply-shift; bias is below 2^-32)
+    uint32_t NextInt(uint32_t bound) {
+        return (uint32_t)(((Next() >> 32) * (uint64_t)bound) >> 32);
+    }
+    // Uniform float in [0, 1) with 24 random bits
+    float NextFloat() {
+        return (float)(Next() >> 40) * (1.0f / 16777216.0f);
+    }
+    float Range(float low, float high) {
+        return low + (high - low) * NextFloat();
+    }
+
+    // Advances 2^128 draws: the start of the next non-overlapping stream
+    void Jump();
+
+    // Raw state, for saving and restoring a generator exactly
+    uint64_t state[4];
+
+    private:
+    static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of worker threads used to split per-boid work.
+// Workers sleep between jobs, so a step only pays for a wake-up, not for
+// creating threads. The calling thread also takes part in every job.
+class ThreadPool {
+    public:
+    // threadCount counts the calling thread, so 1 means "run inline"
+    explicit ThreadPool(size_t threadCount = 1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Resize(size_t threadCount);
+    size_t ThreadCount() const { return workers.size() + 1; }
+
+    // Calls fn(begin, end) over [0, count) in chunks of at most 'grain' items
+    // and blocks until every chunk has finished. Chunks always start at multiples
+    // of 'grain', whatever the thread count (inline runs included)
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    static size_t HardwareThreads();
+
+    private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    // Current job, guarded by mutex
+    const std::function<void(size_t, size_t)>* job;
+    size_t jobCount;
+    size_t jobGrain;
+    size_t nextChunk;
+    size_t chunksLeft;
+    unsigned long generation;
+    bool stopping;
+
+    void Start(size_t workerCount);
+    void Stop();
+    void WorkerLoop();
+    // Runs chunks of the current job until none are left; expects the lock held
+    void RunChunks(std::unique_lock<std::mutex>& lock);
+};
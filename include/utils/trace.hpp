@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Records named begin/end spans and writes them as Chrome trace_event JSON
+// (chrome://tracing, ui.perfetto.dev).
+//
+// Each thread appends to its own fixed-size ring, so recording takes no lock and
+// the oldest spans are overwritten once a ring is full. Tracing costs nothing when
+// compiled out (BOIDS_ENABLE_TRACING=0) and one relaxed atomic load per span when
+// compiled in but switched off at runtime.
+class Tracer {
+    public:
+    static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+    static void SetEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+    // Name shown for the calling thread in the viewer ('name' must outlive the tracer)
+    static void SetThreadName(const char* name);
+
+    static uint64_t NowNanoseconds();
+    // 'name' must outlive the tracer (a string literal)
+    static void Record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+    // Writes the spans recorded since the previous dump that are still held in the
+    // rings, so consecutive dumps do not repeat each other. Safe while other threads
+    // keep recording: slots they overwrite during the copy are dropped.
+    static bool WriteJson(const std::string& path);
+    // Spans a WriteJson call would write now
+    static size_t EventCount();
+    static void Clear();
+
+    private:
+    static std::atomic<bool> enabled;
+};
+
+// Records the lifetime of the enclosing scope as one complete span
+class TraceScope {
+    public:
+    explicit TraceScope(const char* spanName)
+        : name(Tracer::Enabled() ? spanName : nullptr), begin(name ? Tracer::NowNanoseconds() : 0) {}
+    ~TraceScope() {
+        if (name) Tracer::Record(name, begin, Tracer::NowNanoseconds());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+    const char* name;
+    uint64_t begin;
+};
+
+#ifndef BOIDS_ENABLE_TRACING
+#define BOIDS_ENABLE_TRACING 0
+#endif
+
+#if BOIDS_ENABLE_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+
+// Single-producer / single-consumer triple buffer.
+// The writer fills WriteBuffer() and calls Publish(); the reader calls Acquire()
+// and gets the most recent published slot. Neither side ever blocks or waits for
+// the other: they only swap slot indices through one atomic word.
+template <typename T>
+class TripleBuffer {
+    public:
+    TripleBuffer() : middle(1), backIndex(0), frontIndex(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side: slot owned by the writer until the next Publish()
+    T& WriteBuffer() { return slots[backIndex]; }
+
+    // Writer side: hands the filled slot to the reader and takes back a free one.
+    // A slot the reader never acquired is simply overwritten later.
+    void Publish() {
+        int previous = middle.exchange(backIndex | FRESH_BIT, std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+    }
+
+    // Reader side: newest published slot; it stays untouched until the next Acquire()
+    const T& Acquire() {
+        if (middle.load(std::memory_order_relaxed) & FRESH_BIT) {
+            int previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+            frontIndex = previous & INDEX_MASK;
+        }
+        return slots[frontIndex];
+    }
+
+    private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    T slots[3];
+    // Index of the slot in transit plus FRESH_BIT when it holds unread data
+    std::atomic<int> middle;
+    int backIndex;   // writer only
+    int frontIndex;  // reader only
+};
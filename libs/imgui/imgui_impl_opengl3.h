@@ -29,6 +29,8 @@ IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_Init(const char* glsl_version = NULL);
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_NewFrame();
 IMGUI_IMPL_API void     ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data);
+// Desktop GL 3.2+: upload through the streaming ring buffers (default) or per draw list with glBufferData
+IMGUI_IMPL_API void     ImGui_ImplOpenGL3_SetStreamingBuffers(bool enabled);
 
 // (Optional) Called by Init/NewFrame/Shutdown
 IMGUI_IMPL_API bool     ImGui_ImplOpenGL3_CreateFontsTexture();
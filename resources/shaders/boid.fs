@@ -0,0 +1,51 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+flat in vec3 BoidColor;
+
+uniform vec3 lightColor;
+uniform vec3 lightPos;
+uniform bool useLighting;
+
+const vec3 skyTop    = vec3(0.10, 0.20, 0.45);
+const vec3 skyBottom = vec3(0.55, 0.75, 0.95);
+
+// Mesma iluminação do testing.fs, mas com a cor vinda de cada instância
+void main()
+{
+    if (!useLighting)
+    {
+        // Cor pura para sombras
+        FragColor = vec4(BoidColor, 1.0);
+        return;
+    }
+
+    // Acima do horizonte aplica o mesmo gradiente de céu do testing.fs
+    if (FragPos.y > 150.0)
+    {
+        float t = clamp((FragPos.y - 150.0) / 200.0, 0.0, 1.0);
+        FragColor = vec4(mix(skyBottom, skyTop, t), 1.0);
+        return;
+    }
+
+    // 1. Luz Ambiente
+    float ambientStrength = 0.35;
+    vec3 ambient = ambientStrength * lightColor;
+
+    // 2. Luz Difusa
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    vec3 result = (ambient + diffuse) * BoidColor;
+
+    // --- NEBLINA SUAVE (FOG) ---
+    float distance = length(FragPos - vec3(0, 40, 60)); // olho aproximado
+    float fogAmount = clamp((distance - 50.0) / 300.0, 0.0, 1.0);
+    result = mix(result, skyBottom, fogAmount);
+
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,64 @@
+#version 330 core
+// Malha do boid: as 4 partes (corpo, cabeça, asas) já com partPost aplicada
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 6) in vec3 aPartOrigin;   // translação partPre da parte
+layout (location = 7) in float aWingSign;    // 0 = sem batida, +1 asa esquerda, -1 asa direita
+layout (location = 8) in vec3 aColor;
+layout (location = 9) in vec3 aLeaderColor;
+
+// Atributos por instância (um boid por instância)
+layout (location = 2) in vec3 iPosition;
+layout (location = 3) in vec3 iForward;
+layout (location = 4) in float iWingAngle;
+layout (location = 5) in float iLeader;
+
+uniform mat4 view;
+uniform mat4 projection;
+// Projeção planar a partir da luz sobre o chão, calculada uma vez por frame
+uniform mat4 shadowProjection;
+uniform bool shadowPass;
+
+out vec3 FragPos;
+out vec3 Normal;
+flat out vec3 BoidColor;
+
+// Mesma base ortonormal de calculateOrientation()
+mat3 Orientation(vec3 forwardVector)
+{
+    if (length(forwardVector) < 0.01 || isnan(forwardVector.x))
+        forwardVector = vec3(0.0, 0.0, 1.0);
+
+    vec3 forward = normalize(forwardVector);
+    vec3 up = vec3(0.0, 1.0, 0.0);
+    if (abs(dot(forward, up)) > 0.99) up = vec3(0.0, 0.0, 1.0);
+
+    vec3 right = normalize(cross(up, forward));
+    vec3 realUp = cross(forward, right);
+    return mat3(right, realUp, forward);
+}
+
+void main()
+{
+    mat3 rotation = Orientation(iForward);
+
+    float angle = radians(sin(iWingAngle) * 30.0) * aWingSign;
+    float c = cos(angle);
+    float s = sin(angle);
+    mat3 wing = mat3( c,   s,   0.0,
+                     -s,   c,   0.0,
+                      0.0, 0.0, 1.0);
+
+    // partPre * rotação da asa * partPost, igual ao DrawBoidParts
+    vec3 local = aPartOrigin + wing * aPos;
+    vec3 worldPos = iPosition + rotation * local;
+
+    // Sombra: o boid inteiro projetado no chão na direção da luz
+    vec4 drawPos = shadowPass ? shadowProjection * vec4(worldPos, 1.0) : vec4(worldPos, 1.0);
+    gl_Position = projection * view * drawPos;
+
+    FragPos = worldPos;
+    // Rotações são ortonormais e a escala da parte já está nas normais da malha
+    Normal = rotation * wing * aNormal;
+    BoidColor = shadowPass ? vec3(0.0) : mix(aColor, aLeaderColor, iLeader);
+}
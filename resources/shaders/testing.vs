@@ -3,6 +3,8 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
 uniform mat4 model;
+// Transposta inversa de mat3(model), calculada na CPU uma vez por desenho
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -15,6 +17,6 @@ void main()
     
     // Passa a Posição e a Normal (transformadas) para o fragment shader
     FragPos = vec3(model * vec4(aPos, 1.0));
-    // Usa a transposta inversa para transformar a normal (evita distorção com escala)
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    // Transposta inversa (evita distorção com escala), sem inverter matriz por vértice
+    Normal = normalMatrix * aNormal;
 }
\ No newline at end of file
@@ -0,0 +1,363 @@
+// Benchmark suite for the flock simulation (no window or OpenGL needed).
+// For every flock size x density it times full FlockSimulation::Step calls and then
+// replays the step phase by phase on the frozen final state, single-threaded:
+//   grid build, neighbor search (grid queries), force accumulation (neighbor kernel +
+//   flocking/leader forces), obstacle avoidance and integration.
+// Results go out as JSON (ns/boid/step per phase, neighbors visited and cache-miss
+// proxies) so runs from different commits can be diffed or plotted.
+//
+// Usage: boids-bench [--sizes 100,1000,...] [--densities 0.25,1,4] [--steps N] [--warmup N]
+//                    [--budget BOID_STEPS] [--reps N] [--dt S] [--seed N] [--threads N]
+//                    [--brute] [--kernel scalar|sse4|avx2] [--out FILE]
+//
+// Density is boids per SEPARATION_RADIUS^3 (1 = the boids-headless spawn).
+#include "simulation/flock_simulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchOptions {
+    std::vector<int> sizes = { 100, 1000, 10000, 50000, 200000 };
+    std::vector<float> densities = { 0.25f, 1.0f, 4.0f };
+    // 0 = pick per size so each config runs about 'budget' boid-steps
+    int steps = 0;
+    int warmup = 2;
+    double budget = 2e6;
+    // Repetitions of each isolated phase; the fastest one is reported
+    int reps = 3;
+    float dt = 1.0f / 60.0f;
+    uint64_t seed = 1;
+    int threads = (int)ThreadPool::HardwareThreads();
+    bool bruteForce = false;
+    SteeringKernel kernel = BestSteeringKernel();
+    std::string outFile;
+};
+
+// Per-step averages of FlockSimulation::lastStepTimings, in milliseconds
+struct StepResult {
+    int steps = 0;
+    double leader = 0.0;
+    double neighborSearch = 0.0;
+    double integration = 0.0;
+    double total = 0.0;
+};
+
+// Isolated phases, in milliseconds for one pass over the whole flock
+struct PhaseResult {
+    double gridBuild = 0.0;
+    double neighborSearch = 0.0;
+    double forceAccumulation = 0.0;
+    double obstacleAvoidance = 0.0;
+    double integration = 0.0;
+};
+
+// Neighbor traffic of one pass. Without hardware counters, the cache behaviour is
+// estimated from the candidate lists: how many 64-byte lines of each SoA stream a
+// boid's query touches and how far (in slots) its candidates are from it.
+struct NeighborStats {
+    double candidates = 0.0;        // candidates visited (distance tests)
+    double neighbors = 0.0;         // candidates inside PERCEPTION_RADIUS
+    double cacheLines = 0.0;        // distinct lines per stream touched by the candidate list
+    double indexDistance = 0.0;     // mean |candidate - self|
+};
+
+struct ConfigResult {
+    int boids = 0;
+    float density = 0.0f;
+    float side = 0.0f;
+    StepResult step;
+    PhaseResult phases;
+    NeighborStats stats;
+    unsigned long long checksum = 0;
+};
+
+// Streams read by the neighbor kernel: px, py, pz, vx, vy, vz
+const int HOT_STREAMS = 6;
+const int CACHE_LINE_BYTES = 64;
+const int FLOATS_PER_LINE = CACHE_LINE_BYTES / (int)sizeof(float);
+
+static void PrintUsage() {
+    std::cout << "Usage: boids-bench [--sizes 100,1000,...] [--densities 0.25,1,4] [--steps N] [--warmup N]\n"
+              << "                   [--budget BOID_STEPS] [--reps N] [--dt S] [--seed N] [--threads N]\n"
+              << "                   [--brute] [--kernel scalar|sse4|avx2] [--out FILE]\n";
+}
+
+template <typename T>
+static bool ParseList(const char* text, std::vector<T>& out) {
+    out.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        double value = atof(item.c_str());
+        if (value <= 0.0) return false;
+        out.push_back((T)value);
+    }
+    return !out.empty();
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--sizes" && hasValue) ok = ParseList(argv[++i], opt.sizes);
+        else if (arg == "--densities" && hasValue) ok = ParseList(argv[++i], opt.densities);
+        else if (arg == "--steps" && hasValue) opt.steps = atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue) opt.warmup = atoi(argv[++i]);
+        else if (arg == "--budget" && hasValue) opt.budget = atof(argv[++i]);
+        else if (arg == "--reps" && hasValue) opt.reps = atoi(argv[++i]);
+        else if (arg == "--dt" && hasValue) opt.dt = (float)atof(argv[++i]);
+        else if (arg == "--seed" && hasValue) opt.seed = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--threads" && hasValue) opt.threads = atoi(argv[++i]);
+        else if (arg == "--brute") opt.bruteForce = true;
+        else if (arg == "--out" && hasValue) opt.outFile = argv[++i];
+        else if (arg == "--kernel" && hasValue) {
+            std::string name = argv[++i];
+            if (name == "scalar") opt.kernel = SteeringKernel::Scalar;
+            else if (name == "sse4") opt.kernel = SteeringKernel::SSE4;
+            else if (name == "avx2") opt.kernel = SteeringKernel::AVX2;
+            else ok = false;
+            if (ok && !SteeringKernelSupported(opt.kernel)) {
+                std::cout << "ERROR::BENCH::kernel " << name << " is not supported on this CPU" << std::endl;
+                return false;
+            }
+        }
+        else ok = false;
+
+        if (!ok) {
+            PrintUsage();
+            return false;
+        }
+    }
+    return opt.steps >= 0 && opt.warmup >= 0 && opt.reps >= 1 && opt.dt > 0.0f && opt.threads >= 1;
+}
+
+// Same cube as boids-headless, scaled so there are 'density' boids per SEPARATION_RADIUS^3
+static float SpawnFlock(FlockSimulation& sim, int count, float density) {
+    sim.leader.position = glm::vec3(0, 15, TOWER_RADIUS + 15.0f);
+    sim.smoothFlockCenter = sim.leader.position;
+
+    float side = SEPARATION_RADIUS * std::cbrt((float)count / density);
+    sim.Clear();
+    sim.Reserve(count);
+
+    SpawnParams params;
+    params.shape = SpawnShape::Box;
+    params.center = sim.leader.position + glm::vec3(0.0f, 0.5f * side, 0.0f);
+    params.radius = 0.5f * side;
+    params.count = (size_t)count;
+    sim.Spawn(params);
+    return side;
+}
+
+// Fills 'candidates' the way FlockSimulation::GatherNeighbors does
+static void QueryCandidates(const SpatialGrid* grid, const FlockSoA& flock, size_t bi, std::vector<int>& candidates) {
+    if (grid) {
+        grid->Query(flock.Position(bi), candidates);
+    } else if (candidates.size() != flock.Size()) {
+        candidates.resize(flock.Size());
+        for (size_t i = 0; i < candidates.size(); ++i) candidates[i] = (int)i;
+    }
+}
+
+// Runs 'pass' 'reps' times and returns the fastest, in milliseconds
+template <typename Fn>
+static double BestOf(int reps, Fn pass) {
+    double best = 0.0;
+    for (int r = 0; r < reps; ++r) {
+        Stopwatch timer;
+        pass();
+        double ms = timer.Milliseconds();
+        if (r == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+static void MeasurePhases(const FlockSimulation& sim, const BenchOptions& opt, ConfigResult& result) {
+    const FlockSoA& flock = sim.Flock();
+    const size_t count = flock.Size();
+    if (count == 0) return;
+
+    SpatialGrid grid;
+    const SpatialGrid* gridPtr = opt.bruteForce ? NULL : &grid;
+    SteeringKernelFn kernel = SelectSteeringKernel(opt.kernel);
+    std::vector<int> candidates;
+    std::vector<NeighborSums> sums(count);
+    std::vector<glm::vec3> acceleration(count);
+    FlockSoA next = flock;
+
+    // Grid build (counted inside neighbor search too, as in Step)
+    if (gridPtr) {
+        result.phases.gridBuild = BestOf(opt.reps, [&]() {
+            grid.Build(PERCEPTION_RADIUS, flock.px, flock.py, flock.pz);
+        });
+    }
+
+    // Queries alone; the neighbor traffic is counted on this pass
+    double queries = BestOf(opt.reps, [&]() {
+        for (size_t bi = 0; bi < count; ++bi) QueryCandidates(gridPtr, flock, bi, candidates);
+    });
+    result.phases.neighborSearch = result.phases.gridBuild + queries;
+
+    double visited = 0.0, lines = 0.0, distance = 0.0;
+    for (size_t bi = 0; bi < count; ++bi) {
+        QueryCandidates(gridPtr, flock, bi, candidates);
+        visited += (double)candidates.size();
+        // Candidates are sorted, so a new line starts whenever the line index changes
+        int lastLine = -1;
+        for (int c : candidates) {
+            int line = c / FLOATS_PER_LINE;
+            if (line != lastLine) lines += 1.0;
+            lastLine = line;
+            distance += std::abs((double)c - (double)bi);
+        }
+    }
+
+    // Neighbor sums need the candidate lists, so that pass repeats the queries and
+    // the query time is subtracted
+    double gather = BestOf(opt.reps, [&]() {
+        for (size_t bi = 0; bi < count; ++bi) {
+            QueryCandidates(gridPtr, flock, bi, candidates);
+            kernel(flock, bi, candidates.data(), candidates.size(), sums[bi]);
+        }
+    });
+    double steering = BestOf(opt.reps, [&]() {
+        for (size_t bi = 0; bi < count; ++bi)
+            acceleration[bi] = sim.FlockingForce(flock.Position(bi), flock.Velocity(bi), sums[bi]);
+    });
+    result.phases.forceAccumulation = std::max(0.0, gather - queries) + steering;
+
+    // Each repetition starts from the flocking forces again
+    std::vector<glm::vec3> flocking = acceleration;
+    result.phases.obstacleAvoidance = BestOf(opt.reps, [&]() {
+        std::copy(flocking.begin(), flocking.end(), acceleration.begin());
+        for (size_t bi = 0; bi < count; ++bi)
+            sim.AddObstacleForces(flock.Position(bi), flock.Velocity(bi), acceleration[bi]);
+    });
+    result.phases.integration = BestOf(opt.reps, [&]() {
+        for (size_t bi = 0; bi < count; ++bi)
+            sim.IntegrateMotion(bi, flock, next, opt.dt, acceleration[bi]);
+    });
+
+    double found = 0.0;
+    for (const NeighborSums& s : sums) found += s.count;
+
+    result.stats.candidates = visited / count;
+    result.stats.neighbors = found / count;
+    result.stats.cacheLines = lines / count;
+    result.stats.indexDistance = visited > 0.0 ? distance / visited : 0.0;
+}
+
+static ConfigResult RunConfig(int boids, float density, const BenchOptions& opt) {
+    ConfigResult result;
+    result.boids = boids;
+    result.density = density;
+
+    FlockSimulation sim;
+    sim.Seed(opt.seed);
+    sim.threadCount = opt.threads;
+    sim.useSpatialGrid = !opt.bruteForce;
+    sim.steeringKernel = opt.kernel;
+    result.side = SpawnFlock(sim, boids, density);
+
+    int steps = opt.steps;
+    if (steps == 0) steps = (int)std::min(200.0, std::max(3.0, opt.budget / std::max(boids, 1)));
+
+    for (int i = 0; i < opt.warmup; ++i) sim.Step(opt.dt);
+
+    StepResult& step = result.step;
+    for (int i = 0; i < steps; ++i) {
+        sim.Step(opt.dt);
+        const StepTimings& t = sim.lastStepTimings;
+        step.leader += t.leader;
+        step.neighborSearch += t.neighborSearch;
+        step.integration += t.integration;
+        step.total += t.total;
+    }
+    step.steps = steps;
+    step.leader /= steps;
+    step.neighborSearch /= steps;
+    step.integration /= steps;
+    step.total /= steps;
+    result.checksum = sim.Checksum();
+
+    MeasurePhases(sim, opt, result);
+    return result;
+}
+
+static double NsPerBoid(double milliseconds, int boids) {
+    return boids > 0 ? milliseconds * 1e6 / boids : 0.0;
+}
+
+static void WriteJson(FILE* file, const BenchOptions& opt, const std::vector<ConfigResult>& results) {
+    fprintf(file, "{\n  \"benchmark\": \"boids-bench\",\n");
+    fprintf(file, "  \"kernel\": \"%s\",\n  \"neighbors\": \"%s\",\n  \"threads\": %d,\n",
+            SteeringKernelName(opt.kernel), opt.bruteForce ? "brute-force" : "grid", opt.threads);
+    fprintf(file, "  \"seed\": %llu,\n  \"dt\": %.6g,\n  \"phase_reps\": %d,\n",
+            (unsigned long long)opt.seed, opt.dt, opt.reps);
+    fputs("  \"results\": [", file);
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const ConfigResult& r = results[i];
+        const StepResult& s = r.step;
+        const PhaseResult& p = r.phases;
+        double hotBytes = (double)r.boids * HOT_STREAMS * sizeof(float);
+
+        fprintf(file, "%s\n    {\n", i == 0 ? "" : ",");
+        fprintf(file, "      \"boids\": %d,\n      \"density\": %.6g,\n      \"side\": %.6g,\n      \"steps\": %d,\n",
+                r.boids, r.density, r.side, s.steps);
+        fprintf(file, "      \"checksum\": \"%016llx\",\n", r.checksum);
+        fprintf(file, "      \"step_ms\": {\"leader\": %.6f, \"neighbor_search\": %.6f, \"integration\": %.6f, \"total\": %.6f},\n",
+                s.leader, s.neighborSearch, s.integration, s.total);
+        fprintf(file, "      \"ns_per_boid_step\": %.3f,\n", NsPerBoid(s.total, r.boids));
+        fprintf(file, "      \"phase_ns_per_boid\": {\"grid_build\": %.3f, \"neighbor_search\": %.3f, "
+                      "\"force_accumulation\": %.3f, \"obstacle_avoidance\": %.3f, \"integration\": %.3f},\n",
+                NsPerBoid(p.gridBuild, r.boids), NsPerBoid(p.neighborSearch, r.boids),
+                NsPerBoid(p.forceAccumulation, r.boids), NsPerBoid(p.obstacleAvoidance, r.boids),
+                NsPerBoid(p.integration, r.boids));
+        fprintf(file, "      \"neighbors\": {\"visited_per_boid\": %.3f, \"found_per_boid\": %.3f, \"hit_ratio\": %.4f},\n",
+                r.stats.candidates, r.stats.neighbors,
+                r.stats.candidates > 0.0 ? r.stats.neighbors / r.stats.candidates : 0.0);
+        fprintf(file, "      \"cache_proxies\": {\"lines_per_boid\": %.3f, \"bytes_per_boid\": %.1f, "
+                      "\"mean_index_distance\": %.1f, \"hot_stream_bytes\": %.0f}\n",
+                r.stats.cacheLines, r.stats.cacheLines * CACHE_LINE_BYTES * HOT_STREAMS,
+                r.stats.indexDistance, hotBytes);
+        fputs("    }", file);
+    }
+    fputs("\n  ]\n}\n", file);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!ParseOptions(argc, argv, opt)) return 1;
+
+    std::vector<ConfigResult> results;
+    for (int boids : opt.sizes) {
+        for (float density : opt.densities) {
+            ConfigResult r = RunConfig(boids, density, opt);
+            // Progress on stderr so stdout stays valid JSON
+            fprintf(stderr, "boids=%d density=%g: %.1f ns/boid/step, %.1f neighbors visited/boid\n",
+                    r.boids, r.density, NsPerBoid(r.step.total, r.boids), r.stats.candidates);
+            results.push_back(r);
+        }
+    }
+
+    if (opt.outFile.empty()) {
+        WriteJson(stdout, opt, results);
+        return 0;
+    }
+    FILE* file = fopen(opt.outFile.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::BENCH::COULD_NOT_OPEN_FILE " << opt.outFile << std::endl;
+        return 1;
+    }
+    WriteJson(file, opt, results);
+    fclose(file);
+    std::cout << "INFO::BENCH::WROTE " << results.size() << " results to " << opt.outFile << std::endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Microbenchmark for Shader uniform uploads.
+// Replays the per-boid uniform traffic of the non-instanced Render() path (one lit
+// DrawBoidParts per boid: 3 objectColor plus a model and a normal matrix for each
+// of the 4 parts, 11 uniform calls; useLighting once per frame; shadows are one
+// instanced draw) and times it with a per-call glGetUniformLocation, the cached
+// name lookup and UniformHandles.
+//
+// Usage: boids-uniform-bench [boids=5000] [frames=200]
+// Run from the build directory so resources/shaders/ is found.
+#include "glad.h"
+#include "glfw3.h"
+#include "shaders/shader.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <glm/glm.hpp>
+
+enum class Mode { GlLookup, CachedName, Handle };
+
+struct Handles {
+    UniformHandle model, normalMatrix, objectColor, useLighting;
+};
+
+static void UploadLookup(const Shader& s, const std::string& name, const glm::mat4& m) {
+    // What every Shader::set* call did before the cache existed
+    glUniformMatrix4fv(glGetUniformLocation(s.programID, name.c_str()), 1, GL_FALSE, &m[0][0]);
+}
+static void UploadLookup(const Shader& s, const std::string& name, const glm::mat3& m) {
+    glUniformMatrix3fv(glGetUniformLocation(s.programID, name.c_str()), 1, GL_FALSE, &m[0][0]);
+}
+static void UploadLookup(const Shader& s, const std::string& name, const glm::vec3& v) {
+    glUniform3fv(glGetUniformLocation(s.programID, name.c_str()), 1, &v[0]);
+}
+static void UploadLookup(const Shader& s, const std::string& name, bool b) {
+    glUniform1i(glGetUniformLocation(s.programID, name.c_str()), (int)b);
+}
+
+static double RunFrames(const Shader& s, const Handles& h, Mode mode, int boids, int frames) {
+    glm::mat4 model(1.0f);
+    glm::mat3 normalMatrix(1.0f);
+    glm::vec3 color(1.0f, 1.0f, 0.0f);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        switch (mode) {
+            case Mode::GlLookup: UploadLookup(s, "useLighting", true); break;
+            case Mode::CachedName: s.setBool("useLighting", true); break;
+            case Mode::Handle: s.setBool(h.useLighting, true); break;
+        }
+        for (int b = 0; b < boids; b++) {
+            model[3][0] = (float)b;
+            switch (mode) {
+                case Mode::GlLookup:
+                    for (int c = 0; c < 3; c++) UploadLookup(s, "objectColor", color);
+                    for (int p = 0; p < 4; p++) {
+                        UploadLookup(s, "model", model);
+                        UploadLookup(s, "normalMatrix", normalMatrix);
+                    }
+                    break;
+                case Mode::CachedName:
+                    for (int c = 0; c < 3; c++) s.setVec3("objectColor", color);
+                    for (int p = 0; p < 4; p++) {
+                        s.setMat4("model", model);
+                        s.setMat3("normalMatrix", normalMatrix);
+                    }
+                    break;
+                case Mode::Handle:
+                    for (int c = 0; c < 3; c++) s.setVec3(h.objectColor, color);
+                    for (int p = 0; p < 4; p++) {
+                        s.setMat4(h.model, model);
+                        s.setMat3(h.normalMatrix, normalMatrix);
+                    }
+                    break;
+            }
+        }
+        glFinish();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main(int argc, char** argv) {
+    int boids = argc > 1 ? atoi(argv[1]) : 5000;
+    int frames = argc > 2 ? atoi(argv[2]) : 200;
+    if (boids < 0 || frames < 1) {
+        std::cout << "Usage: boids-uniform-bench [boids=5000] [frames=200] (frames >= 1)" << std::endl;
+        return 1;
+    }
+
+    if (!glfwInit()) {
+        std::cout << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "uniform-bench", NULL, NULL);
+    if (window == NULL) {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+
+    Shader s = Shader::LoadShader("resources/shaders/testing.vs", "resources/shaders/testing.fs");
+    s.use();
+    Handles h;
+    h.model = s.GetUniformHandle("model");
+    h.normalMatrix = s.GetUniformHandle("normalMatrix");
+    h.objectColor = s.GetUniformHandle("objectColor");
+    h.useLighting = s.GetUniformHandle("useLighting");
+
+    // Warm-up so driver-side allocations don't land in the first measurement
+    RunFrames(s, h, Mode::Handle, boids, 5);
+
+    double lookupMs = RunFrames(s, h, Mode::GlLookup, boids, frames);
+    double cachedMs = RunFrames(s, h, Mode::CachedName, boids, frames);
+    double handleMs = RunFrames(s, h, Mode::Handle, boids, frames);
+
+    int callsPerFrame = boids * 11 + 1;
+    printf("boids=%d frames=%d uniform calls/frame=%d\n", boids, frames, callsPerFrame);
+    printf("  glGetUniformLocation per call : %8.3f ms/frame\n", lookupMs);
+    printf("  cached name lookup            : %8.3f ms/frame (saves %.3f ms)\n", cachedMs, lookupMs - cachedMs);
+    printf("  UniformHandle                 : %8.3f ms/frame (saves %.3f ms)\n", handleMs, lookupMs - handleMs);
+
+    s.Unload();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "display/base_window.hpp"
+#include "utils/trace.hpp"
 #include <iostream>
 
 BaseWindow::BaseWindow() {
@@ -12,8 +13,14 @@ BaseWindow::BaseWindow(int width, int height, std::string title) {
 }
 
 int BaseWindow::Run() {
+    Tracer::SetThreadName("main");
+
     // Iniialize GLFW
-    glfwInit();
+    ConfigurePlatform();
+    if (!glfwInit()) {
+        std::cout << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
 
     // Run initialisation logic
     Initialize();
@@ -41,6 +48,7 @@ int BaseWindow::Run() {
 
     // Main game loop
     while (!glfwWindowShouldClose(windowHandle)) {
+        TRACE_SCOPE("Frame");
         Update();
         Render();
     }
@@ -0,0 +1,153 @@
+#include "display/frustum_culling.hpp"
+
+// SSE is part of every x86-64 target, so the 4-wide path needs no runtime dispatch
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BOIDS_CULL_SSE 1
+#include <xmmintrin.h>
+#else
+#define BOIDS_CULL_SSE 0
+#endif
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection) {
+    // glm is column-major: row r is (m[0][r], m[1][r], m[2][r], m[3][r])
+    glm::vec4 rows[4];
+    for (int r = 0; r < 4; ++r) {
+        rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+    }
+
+    // OpenGL clip space: -w <= x, y, z <= w
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0];
+    frustum.planes[1] = rows[3] - rows[0];
+    frustum.planes[2] = rows[3] + rows[1];
+    frustum.planes[3] = rows[3] - rows[1];
+    frustum.planes[4] = rows[3] + rows[2];
+    frustum.planes[5] = rows[3] - rows[2];
+    for (glm::vec4& plane : frustum.planes) plane /= glm::length(glm::vec3(plane));
+    return frustum;
+}
+
+bool Frustum::SphereVisible(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+    }
+    return true;
+}
+
+namespace {
+
+// Below this the light is (nearly) inside the sphere and the shadow is unbounded
+const float MIN_LIGHT_CLEARANCE = 1e-3f;
+
+// A point p within 'radius' of the center c lands at L + t(p) * (p - L), with
+// t(p) = drop / (L.y - p.y) and drop = L.y - height. Since t(p) <= tMax = drop / nearest
+// (nearest = L.y - c.y - radius), its distance to the shadow of c is at most
+// tMax * radius * (1 + |c - L| / (L.y - c.y)).
+uint8_t CullOne(const Frustum& frustum, const PlanarShadow& shadow, float radius, const float* position) {
+    glm::vec3 center(position[0], position[1], position[2]);
+    uint8_t flags = frustum.SphereVisible(center, radius) ? CULL_BOID_VISIBLE : 0;
+
+    float above = shadow.light.y - center.y;
+    float nearest = above - radius;
+    if (nearest <= MIN_LIGHT_CLEARANCE) return flags | CULL_SHADOW_VISIBLE;
+
+    float drop = shadow.light.y - shadow.height;
+    float t = drop / above;
+    glm::vec3 fromLight = center - shadow.light;
+    glm::vec3 shadowCenter(shadow.light.x + t * fromLight.x, shadow.height, shadow.light.z + t * fromLight.z);
+    float shadowRadius = drop / nearest * radius * (1.0f + glm::length(fromLight) / above);
+    if (frustum.SphereVisible(shadowCenter, shadowRadius)) flags |= CULL_SHADOW_VISIBLE;
+    return flags;
+}
+
+#if BOIDS_CULL_SSE
+struct PlaneLanes {
+    __m128 x, y, z, w;
+};
+
+// All-ones in the lanes whose sphere is not entirely behind any plane
+inline __m128 InsideMask(const PlaneLanes* planes, __m128 x, __m128 y, __m128 z, __m128 negativeRadius) {
+    __m128 inside = _mm_setzero_ps();
+    for (int p = 0; p < 6; ++p) {
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p].x, x), _mm_mul_ps(planes[p].y, y)),
+                                     _mm_add_ps(_mm_mul_ps(planes[p].z, z), planes[p].w));
+        __m128 ok = _mm_cmpge_ps(distance, negativeRadius);
+        inside = p == 0 ? ok : _mm_and_ps(inside, ok);
+    }
+    return inside;
+}
+#endif
+
+} // namespace
+
+CullCounts CullBoids(const Frustum& frustum, const PlanarShadow& shadow, float radius,
+                     const float* positions, size_t stride, size_t begin, size_t end, uint8_t* flags) {
+    CullCounts counts;
+    const unsigned char* base = reinterpret_cast<const unsigned char*>(positions);
+    size_t i = begin;
+
+#if BOIDS_CULL_SSE
+    PlaneLanes planes[6];
+    for (int p = 0; p < 6; ++p) {
+        planes[p].x = _mm_set1_ps(frustum.planes[p].x);
+        planes[p].y = _mm_set1_ps(frustum.planes[p].y);
+        planes[p].z = _mm_set1_ps(frustum.planes[p].z);
+        planes[p].w = _mm_set1_ps(frustum.planes[p].w);
+    }
+    const __m128 r = _mm_set1_ps(radius);
+    const __m128 negativeRadius = _mm_set1_ps(-radius);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 clearance = _mm_set1_ps(MIN_LIGHT_CLEARANCE);
+    const __m128 lightX = _mm_set1_ps(shadow.light.x);
+    const __m128 lightY = _mm_set1_ps(shadow.light.y);
+    const __m128 lightZ = _mm_set1_ps(shadow.light.z);
+    const __m128 height = _mm_set1_ps(shadow.height);
+    const __m128 drop = _mm_set1_ps(shadow.light.y - shadow.height);
+
+    for (; i + 4 <= end; i += 4) {
+        // 4 records (x, y, z, whatever follows) transposed into x, y, z lanes
+        const unsigned char* record = base + i * stride;
+        __m128 x = _mm_loadu_ps(reinterpret_cast<const float*>(record));
+        __m128 y = _mm_loadu_ps(reinterpret_cast<const float*>(record + stride));
+        __m128 z = _mm_loadu_ps(reinterpret_cast<const float*>(record + 2 * stride));
+        __m128 unused = _mm_loadu_ps(reinterpret_cast<const float*>(record + 3 * stride));
+        _MM_TRANSPOSE4_PS(x, y, z, unused);
+
+        __m128 boidMask = InsideMask(planes, x, y, z, negativeRadius);
+
+        // Same bound as CullOne; lanes too close to the light keep their shadow
+        __m128 above = _mm_sub_ps(lightY, y);
+        __m128 nearest = _mm_sub_ps(above, r);
+        __m128 unbounded = _mm_cmple_ps(nearest, clearance);
+        __m128 t = _mm_div_ps(drop, above);
+        __m128 dx = _mm_sub_ps(x, lightX);
+        __m128 dy = _mm_sub_ps(y, lightY);
+        __m128 dz = _mm_sub_ps(z, lightZ);
+        __m128 shadowX = _mm_add_ps(lightX, _mm_mul_ps(t, dx));
+        __m128 shadowZ = _mm_add_ps(lightZ, _mm_mul_ps(t, dz));
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 shadowRadius = _mm_mul_ps(_mm_mul_ps(_mm_div_ps(drop, nearest), r),
+                                         _mm_add_ps(one, _mm_div_ps(distance, above)));
+        __m128 shadowMask = InsideMask(planes, shadowX, height, shadowZ, _mm_sub_ps(_mm_setzero_ps(), shadowRadius));
+        shadowMask = _mm_or_ps(shadowMask, unbounded);
+
+        int boidBits = _mm_movemask_ps(boidMask);
+        int shadowBits = _mm_movemask_ps(shadowMask);
+        for (int lane = 0; lane < 4; ++lane) {
+            int boidVisible = (boidBits >> lane) & 1;
+            int shadowVisible = (shadowBits >> lane) & 1;
+            flags[i + lane] = (uint8_t)((boidVisible ? CULL_BOID_VISIBLE : 0) | (shadowVisible ? CULL_SHADOW_VISIBLE : 0));
+            counts.boids += boidVisible;
+            counts.shadows += shadowVisible;
+        }
+    }
+#endif
+
+    for (; i < end; ++i) {
+        uint8_t result = CullOne(frustum, shadow, radius, reinterpret_cast<const float*>(base + i * stride));
+        flags[i] = result;
+        if (result & CULL_BOID_VISIBLE) counts.boids++;
+        if (result & CULL_SHADOW_VISIBLE) counts.shadows++;
+    }
+    return counts;
+}
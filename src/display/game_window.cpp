@@ -1,10 +1,27 @@
 #include "display/game_window.hpp"
+#include "display/frustum_culling.hpp"
+#include "display/gl_call_stats.hpp"
+#include "display/gpu_timer.hpp"
+#include "display/render_bench.hpp"
 #include "shaders/shader.hpp"
+#include "shaders/shader_compiler.hpp"
+#include "simulation/flock_simulation.hpp"
+#include "simulation/fixed_timestep.hpp"
+#include "simulation/input_log.hpp"
+#include "simulation/simulation_thread.hpp"
+#include "simulation/trajectory_recorder.hpp"
+#include "utils/file_watcher.hpp"
+#include "utils/profiler.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/trace.hpp"
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <cstdlib>
+#include <cstddef>
+#include <cstdio>
 #include <string>
+#include <algorithm>
 
 // GLM
 #include <glm/glm.hpp>
@@ -44,62 +61,66 @@ static unsigned int CreateProgramFromSrc(const char* vsSrc, const char* fsSrc) {
     return prog;
 }
 
-// ---  OBSTÁCULO
-const float TOWER_RADIUS = 15.0f;
-const float TOWER_HEIGHT = 80.0f;
-const float GROUND_AVOID_HEIGHT = 5.0f;
-const float OBSTACLE_AVOID_RADIUS = TOWER_RADIUS + 2.0f;
-// ------------------------------------------
-
-// --- TUNING: BOIDS ÁGEIS ---
-const float PERCEPTION_RADIUS = 12.0f;
-const float SEPARATION_RADIUS = 4.0f;
-const float MAX_SPEED = 10.0f;
-const float MIN_SPEED = 4.0f;
-const float MAX_FORCE = 2.0f;
-
-// PESOS
-const float WEIGHT_SEPARATION = 5.0f;
-const float WEIGHT_ALIGNMENT  = 1.5f;
-const float WEIGHT_COHESION   = 1.5f;
-const float WEIGHT_GOAL       = 5.0f;
-const float WEIGHT_AVOID_FLOOR= 10.0f;
-// NOVO: Peso da força de desvio (alta prioridade)
-const float WEIGHT_AVOID_OBSTACLE = 15.0f;
-
-// --- Parâmetros do líder ---
-const float LEADER_THRUST = 80.0f;
-const float LEADER_MAX_SPEED = 9.0f;
-const float LEADER_DAMPING = 0.96f;
-
-// --- Câmera ---
-const float CAMERA_SMOOTH_SPEED = 2.0f;
-
-struct Boid {
+// --- GLOBAIS ---
+Shader s;
+// Simulação do bando (biblioteca boids-sim, sem dependência de janela/GL)
+FlockSimulation sim;
+// Opcional: a simulação roda na própria thread e o render lê snapshots.
+// Enquanto ela roda, nada aqui toca em 'sim': a entrada vira SimCommand.
+SimulationThread simThread(sim);
+bool useSimThread = false;
+// Opções da simulação editadas pela UI (aplicadas via SubmitCommand)
+bool spatialGridEnabled = true;
+int simThreadCount = (int)ThreadPool::HardwareThreads();
+int steeringKernel = (int)BestSteeringKernel();
+// Spawn em massa pela UI
+const int MAX_TARGET_BOIDS = 100000;
+const int SPAWN_BATCH = 1000;
+int targetBoidCount = 21;
+int spawnShape = (int)SpawnShape::Sphere;
+
+// Handles de uniforms, resolvidos uma vez após carregar os shaders:
+// o laço de desenho não faz nenhuma busca por nome
+struct SceneUniforms {
+    UniformHandle model, normalMatrix, view, projection, objectColor, lightColor, lightPos, useLighting;
+} sceneUniforms;
+struct BoidUniforms {
+    UniformHandle view, projection, lightColor, lightPos, useLighting, shadowPass, shadowProjection;
+} boidUniforms;
+int skyModeLocation = -1;
+
+// Renderização instanciada dos boids (o caminho antigo fica para comparação)
+Shader boidShader;
+bool useInstancedBoids = true;
+struct BoidInstance {
     glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 acceleration;
-    glm::vec3 forwardDirection;
+    glm::vec3 forward;
     float wingAngle;
-    float wingSpeed;
-
-    Boid(glm::vec3 startPos) {
-        position = startPos;
-        velocity = glm::vec3((float)(rand()%10-5), 0.0f, (float)(rand()%10-5));
-        if(glm::length(velocity) < 0.1f) velocity = glm::vec3(0,0,1);
-        velocity = glm::normalize(velocity) * MIN_SPEED;
-
-        forwardDirection = glm::normalize(velocity);
-        wingAngle = (float)(rand() % 100);
-        wingSpeed = 15.0f + (float)(rand() % 10);
-        acceleration = glm::vec3(0.0f);
-    }
+    float leader;
 };
-
-// --- GLOBAIS ---
-Shader s;
-Boid leaderBoid(glm::vec3(0.0f, 15.0f, 0.0f));
-std::vector<Boid> flock;
+std::vector<BoidInstance> boidInstances;
+unsigned int VAO_BoidInstanced, VBO_BoidInstances, VBO_BoidMesh;
+size_t boidInstanceCapacity = 0;
+// Primeira instância para onde apontam os atributos 2-5 do VAO
+size_t boidInstanceAttribFirst = 0;
+// CullBoids carrega 4 floats a partir da posição de cada instância
+static_assert(offsetof(BoidInstance, position) == 0 && sizeof(BoidInstance) >= 4 * sizeof(float),
+              "CullBoids reads the position as the first 4 floats of a BoidInstance");
+
+// Frustum culling: a cada frame só os boids (e as sombras) dentro do frustum da câmera
+// ativa vão para a GPU. O teste roda em pedaços no cullPool; cada pedaço depois copia
+// os seus visíveis para a posição dada pela soma dos pedaços anteriores.
+bool frustumCulling = true;
+const size_t CULL_CHUNK = 16384;
+ThreadPool cullPool;
+std::vector<uint8_t> cullFlags;
+std::vector<CullCounts> cullChunks;
+std::vector<BoidInstance> visibleBoidInstances;
+std::vector<BoidInstance> visibleShadowInstances;
+// Raio da esfera que contém a malha do boid com as asas em qualquer ângulo (CreateBoidInstancing)
+float boidBoundingRadius = 0.0f;
+size_t hudCulledBoids = 0;
+size_t hudCulledShadows = 0;
 
 // Geometria
 unsigned int VAO_Floor, VBO_Floor, VAO_Cone, VBO_Cone, VAO_Pyramid, VBO_Pyramid, VAO_Grid, VBO_Grid;
@@ -110,20 +131,81 @@ int gridVertexCount = 0;
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
+// Simulação em passo fixo; o render interpola com renderAlpha entre os dois últimos passos
+FixedTimestep simClock(60.0f, 5);
+float renderAlpha = 1.0f;
+int substepsLastFrame = 0;
+
+// Estado que o frame desenha, vindo direto de 'sim' ou do último snapshot da thread
+glm::vec3 cameraCenter(0.0f, 15.0f, 0.0f);
+glm::vec3 cameraVelocity(0.0f, 0.0f, 1.0f);
+glm::vec3 hudLeaderPosition(0.0f);
+size_t hudBoidCount = 0;
+unsigned long long hudStepIndex = 0;
+float hudStepMilliseconds = 0.0f;
+
+// --- PROFILER ---
+// Tempos de CPU por etapa do frame (ms) e tempos de GPU por passe de desenho
+struct CpuProfile {
+    TimingHistory frame, input, simTotal, simNeighbors, simIntegration, scene, culling, imgui, swap;
+} cpuProfile;
+struct GpuProfile {
+    GpuTimer sky, ground, tower, boids;
+} gpuProfile;
+unsigned long long profiledStepIndex = 0;
+
+// --- HOT RELOAD DOS SHADERS ---
+// Os arquivos são vigiados numa thread própria; o frame só compara um contador.
+// A recompilação também é assíncrona: o programa antigo segue em uso até o novo linkar
+FileWatcher shaderWatcher;
+ShaderCompiler shaderCompiler;
+uint64_t shaderChangesSeen = 0;
+
+void ReloadChangedShaders() {
+    uint64_t changes = shaderWatcher.Changes();
+    if (changes == shaderChangesSeen && !s.ReloadPending() && !boidShader.ReloadPending()) return;
+    shaderChangesSeen = changes;
+    s.ReloadFromFile(shaderWatcher, shaderCompiler);
+    boidShader.ReloadFromFile(shaderWatcher, shaderCompiler);
+}
+
+// --- BENCHMARK DE RENDER ---
+// Frames medidos com --render-bench (os de aquecimento ficam de fora)
+RenderBenchReport renderBenchReport;
+int renderBenchFrame = 0;
+
+// --- TRACE ---
+// F8 liga/desliga a gravação de spans, F9 salva o JSON; ao sair salva o que houver
+int traceDumpCount = 0;
+
+void DumpTrace() {
+    Tracer::WriteJson("boids_trace_" + std::to_string(traceDumpCount++) + ".json");
+}
+
+void AddStepTimings(const StepTimings& timings) {
+    cpuProfile.simTotal.Add(timings.total);
+    cpuProfile.simNeighbors.Add(timings.neighborSearch);
+    cpuProfile.simIntegration.Add(timings.integration);
+}
+
+// Gráfico da janela móvel com min/média/p99 no rótulo
+void PlotTiming(const char* label, const TimingHistory& history) {
+    char overlay[64];
+    snprintf(overlay, sizeof(overlay), "%.2f / %.2f / %.2f",
+             history.Min(), history.Average(), history.Percentile(0.99f));
+    ImGui::Text("%s  %.2f ms", label, history.Latest());
+    ImGui::PushID(label);
+    ImGui::PlotLines("", history.Data(), (int)history.Count(), (int)history.Offset(),
+                     overlay, 0.0f, FLT_MAX, ImVec2(-1.0f, 32.0f));
+    ImGui::PopID();
+}
+
 const int SCR_WIDTH = 800;
 const int SCR_HEIGHT = 600;
 
 // Câmera
 int activeCameraMode = 0;
 
-// Alvos da Câmera (Real vs Suave)
-glm::vec3 flockCenter(0.0f);
-glm::vec3 flockAverageVelocity(0.0f, 0.0f, 1.0f);
-glm::vec3 smoothFlockCenter(0.0f, 15.0f, 0.0f);
-glm::vec3 smoothFlockVelocity(0.0f, 0.0f, 1.0f);
-
-glm::vec3 leaderInputDirection(0.0f);
-
 // Fullscreen quad (sky) runtime objects
 unsigned int skyQuadVAO = 0;
 unsigned int skyQuadVBO = 0;
@@ -166,6 +248,15 @@ glm::mat4 calculateOrientation(glm::vec3 position, glm::vec3 forwardVector) {
 }
 
 // --- GEOMETRIA (COM NORMAIS) ---
+// Pirâmide usada em todas as partes do boid: 12 vértices (posição + normal)
+const int PYRAMID_VERTEX_COUNT = 12;
+const float pyramidVertices[PYRAMID_VERTEX_COUNT * 6] = {
+    -0.5f, -0.5f, 0.0f,  0.0f, 0.0f, -1.0f,  0.5f, -0.5f, 0.0f,  0.0f, 0.0f, -1.0f,  0.0f,  0.5f, 0.0f,  0.0f, 0.0f, -1.0f,
+    -0.5f, -0.5f, 0.0f,  0.0f, -0.87f, 0.5f, 0.5f, -0.5f, 0.0f,  0.0f, -0.87f, 0.5f, 0.0f,  0.0f, 1.0f,  0.0f, -0.87f, 0.5f,
+     0.5f, -0.5f, 0.0f,  0.87f, 0.0f, 0.5f,  0.0f,  0.5f, 0.0f,  0.87f, 0.0f, 0.5f,  0.0f,  0.0f, 1.0f,  0.87f, 0.0f, 0.5f,
+     0.0f,  0.5f, 0.0f, -0.87f, 0.0f, 0.5f, -0.5f, -0.5f, 0.0f, -0.87f, 0.0f, 0.5f, 0.0f,  0.0f, 1.0f, -0.87f, 0.0f, 0.5f
+};
+
 void CreateCommonGeometry() {
     // 1. CHÃO (com normais)
     float size = 200.0f;
@@ -184,12 +275,6 @@ void CreateCommonGeometry() {
 
 
     // 3. PIRÂMIDE GENÉRICA (com normais)
-    float pyramidVertices[] = {
-        -0.5f, -0.5f, 0.0f,  0.0f, 0.0f, -1.0f,  0.5f, -0.5f, 0.0f,  0.0f, 0.0f, -1.0f,  0.0f,  0.5f, 0.0f,  0.0f, 0.0f, -1.0f,
-        -0.5f, -0.5f, 0.0f,  0.0f, -0.87f, 0.5f, 0.5f, -0.5f, 0.0f,  0.0f, -0.87f, 0.5f, 0.0f,  0.0f, 1.0f,  0.0f, -0.87f, 0.5f,
-         0.5f, -0.5f, 0.0f,  0.87f, 0.0f, 0.5f,  0.0f,  0.5f, 0.0f,  0.87f, 0.0f, 0.5f,  0.0f,  0.0f, 1.0f,  0.87f, 0.0f, 0.5f,
-         0.0f,  0.5f, 0.0f, -0.87f, 0.0f, 0.5f, -0.5f, -0.5f, 0.0f, -0.87f, 0.0f, 0.5f, 0.0f,  0.0f, 1.0f, -0.87f, 0.0f, 0.5f
-    };
     glGenVertexArrays(1, &VAO_Pyramid); glGenBuffers(1, &VBO_Pyramid);
     glBindVertexArray(VAO_Pyramid); glBindBuffer(GL_ARRAY_BUFFER, VBO_Pyramid);
     glBufferData(GL_ARRAY_BUFFER, sizeof(pyramidVertices), pyramidVertices, GL_STATIC_DRAW);
@@ -228,229 +313,439 @@ void CreateCommonGeometry() {
     glEnableVertexAttribArray(1);
 }
 
-// --- DESENHO (COM SOMBRA) ---
-void DrawBoidParts(const Boid& boid, glm::mat4 baseMatrix, bool isLeader, bool useLighting) {
+// --- NORMAIS ---
+// O testing.vs recebe a matriz de normais pronta. Os modelos são rotações, translações
+// e escalas, então a transposta inversa sai sem inverter nada: as rotações ficam como
+// estão e cada escala s vira 1/s (o fragment shader normaliza a normal depois).
+glm::mat3 InverseScale(const glm::vec3& scale) {
+    return glm::mat3(glm::scale(glm::mat4(1.0f), 1.0f / scale));
+}
+
+// --- DESENHO ---
+// baseMatrix vem de calculateOrientation: translação + rotação pura
+void DrawBoidParts(float wingAngle, glm::mat4 baseMatrix, bool isLeader, bool useLighting) {
     glBindVertexArray(VAO_Pyramid);
     glm::mat4 model;
+    glm::mat3 baseRotation(baseMatrix);
 
     if (useLighting) {
         glm::vec3 bodyColor = isLeader ? glm::vec3(1.0f, 0.2f, 0.2f) : glm::vec3(1.0f, 1.0f, 0.0f);
-        s.setVec3("objectColor", bodyColor);
+        s.setVec3(sceneUniforms.objectColor, bodyColor);
     }
-    model = glm::scale(baseMatrix, glm::vec3(0.5f, 0.5f, 1.5f));
-    s.setMat4("model", model);
+    glm::vec3 bodyScale(0.5f, 0.5f, 1.5f);
+    model = glm::scale(baseMatrix, bodyScale);
+    s.setMat4(sceneUniforms.model, model);
+    s.setMat3(sceneUniforms.normalMatrix, baseRotation * InverseScale(bodyScale));
     glDrawArrays(GL_TRIANGLES, 0, 12);
 
     if (useLighting) {
-        s.setVec3("objectColor", 1.0f, 0.0f, 0.0f);
+        s.setVec3(sceneUniforms.objectColor, 1.0f, 0.0f, 0.0f);
     }
+    glm::vec3 headScale(0.3f, 0.3f, 0.5f);
     model = glm::translate(baseMatrix, glm::vec3(0.0f, 0.0f, 0.8f));
-    model = glm::scale(model, glm::vec3(0.3f, 0.3f, 0.5f));
-    s.setMat4("model", model);
+    model = glm::scale(model, headScale);
+    s.setMat4(sceneUniforms.model, model);
+    s.setMat3(sceneUniforms.normalMatrix, baseRotation * InverseScale(headScale));
     glDrawArrays(GL_TRIANGLES, 0, 12);
 
     if (useLighting) {
         glm::vec3 wingColor = isLeader ? glm::vec3(1.0f, 0.5f, 0.5f) : glm::vec3(1.0f, 1.0f, 0.5f);
-        s.setVec3("objectColor", wingColor);
+        s.setVec3(sceneUniforms.objectColor, wingColor);
+    }
+    float wingRot = sin(wingAngle) * 30.0f;
+    glm::vec3 wingScale(1.2f, 0.1f, 0.8f);
+
+    for (int side = 0; side < 2; ++side) {
+        float sign = side == 0 ? 1.0f : -1.0f;
+        glm::mat4 flap = glm::rotate(glm::mat4(1.0f), glm::radians(wingRot * sign), glm::vec3(0, 0, 1));
+        glm::mat4 fold = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f * sign), glm::vec3(0, 0, 1));
+
+        model = glm::translate(baseMatrix, glm::vec3(-0.2f * sign, 0.0f, 0.2f));
+        model = model * flap;
+        model = glm::scale(model, wingScale);
+        model = model * fold;
+        s.setMat4(sceneUniforms.model, model);
+        s.setMat3(sceneUniforms.normalMatrix, baseRotation * glm::mat3(flap) * InverseScale(wingScale) * glm::mat3(fold));
+        glDrawArrays(GL_TRIANGLES, 0, 12);
     }
-    float wingRot = sin(boid.wingAngle) * 30.0f;
+}
 
-    model = glm::translate(baseMatrix, glm::vec3(-0.2f, 0.0f, 0.2f));
-    model = glm::rotate(model, glm::radians(wingRot), glm::vec3(0, 0, 1));
-    model = glm::scale(model, glm::vec3(1.2f, 0.1f, 0.8f));
-    model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0,0,1));
-    s.setMat4("model", model);
-    glDrawArrays(GL_TRIANGLES, 0, 12);
+// --- DESENHO INSTANCIADO ---
+// Uma instância por boid. As 4 partes (corpo, cabeça e asas) formam uma única malha,
+// então o bando inteiro sai em 1 glDrawArraysInstanced e as sombras em mais 1,
+// independente do tamanho do bando.
+struct BoidPart {
+    glm::mat4 pre;
+    glm::mat4 post;
+    float wingSign;
+    glm::vec3 color;
+    glm::vec3 leaderColor;
+};
 
-    model = glm::translate(baseMatrix, glm::vec3(0.2f, 0.0f, 0.2f));
-    model = glm::rotate(model, glm::radians(-wingRot), glm::vec3(0, 0, 1));
-    model = glm::scale(model, glm::vec3(1.2f, 0.1f, 0.8f));
-    model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0,0,1));
-    s.setMat4("model", model);
-    glDrawArrays(GL_TRIANGLES, 0, 12);
+// Vértice da malha do boid: pirâmide com partPost aplicada e os dados da parte
+struct BoidMeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec3 partOrigin;
+    float wingSign;
+    glm::vec3 color;
+    glm::vec3 leaderColor;
+};
+const int BOID_PART_COUNT = 4;
+const int BOID_MESH_VERTEX_COUNT = BOID_PART_COUNT * PYRAMID_VERTEX_COUNT;
+
+// Sombras projetadas num plano logo acima do chão (evita z-fighting com ele)
+const float SHADOW_PLANE_HEIGHT = 0.05f;
+const glm::vec3 LIGHT_POSITION(0.0f, 150.0f, 100.0f);
+
+// Projeção de um ponto sobre o plano (a·x + b·y + c·z + d = 0) a partir de uma luz
+// pontual: M = (plano·luz)·I - luz·planoᵀ
+glm::mat4 PlanarShadowMatrix(const glm::vec4& plane, const glm::vec3& lightPosition) {
+    glm::vec4 light(lightPosition, 1.0f);
+    float d = glm::dot(plane, light);
+    glm::mat4 m(0.0f);
+    for (int col = 0; col < 4; ++col)
+        for (int row = 0; row < 4; ++row)
+            m[col][row] = (row == col ? d : 0.0f) - light[row] * plane[col];
+    return m;
 }
 
-// --- LÓGICA DE FLOCKING ---
-glm::vec3 limitVector(glm::vec3 v, float maxVal) {
-    if (glm::length(v) > maxVal) return glm::normalize(v) * maxVal;
-    return v;
+// Aponta os atributos por instância (2-5) para a instância 'first' do VBO_BoidInstances;
+// com o VAO_BoidInstanced ligado. Sem glDrawArraysInstancedBaseInstance no GL 3.3, é
+// assim que o passe dos boids começa depois das sombras no mesmo buffer.
+void BindInstanceAttributes(size_t first) {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_BoidInstances);
+    GLsizei stride = sizeof(BoidInstance);
+    size_t base = first * sizeof(BoidInstance);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BoidInstance, position)));
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BoidInstance, forward)));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BoidInstance, wingAngle)));
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(BoidInstance, leader)));
+    boidInstanceAttribFirst = first;
 }
 
-glm::vec3 SteerTowards(Boid& b, glm::vec3 target) {
-    glm::vec3 desired = target - b.position;
-    float dist = glm::length(desired);
-    if (dist == 0) return glm::vec3(0.0f);
+void CreateBoidInstancing() {
+    // Mesmas transformações de DrawBoidParts, separadas em antes/depois da batida da asa
+    BoidPart parts[BOID_PART_COUNT];
+    parts[0].pre = glm::mat4(1.0f);
+    parts[0].post = glm::scale(glm::mat4(1.0f), glm::vec3(0.5f, 0.5f, 1.5f));
+    parts[0].wingSign = 0.0f;
+    parts[0].color = glm::vec3(1.0f, 1.0f, 0.0f);
+    parts[0].leaderColor = glm::vec3(1.0f, 0.2f, 0.2f);
+
+    parts[1].pre = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.8f));
+    parts[1].post = glm::scale(glm::mat4(1.0f), glm::vec3(0.3f, 0.3f, 0.5f));
+    parts[1].wingSign = 0.0f;
+    parts[1].color = glm::vec3(1.0f, 0.0f, 0.0f);
+    parts[1].leaderColor = glm::vec3(1.0f, 0.0f, 0.0f);
+
+    for (int side = 0; side < 2; ++side) {
+        float sign = side == 0 ? 1.0f : -1.0f;
+        BoidPart& wing = parts[2 + side];
+        wing.pre = glm::translate(glm::mat4(1.0f), glm::vec3(-0.2f * sign, 0.0f, 0.2f));
+        wing.post = glm::scale(glm::mat4(1.0f), glm::vec3(1.2f, 0.1f, 0.8f));
+        wing.post = glm::rotate(wing.post, glm::radians(90.0f * sign), glm::vec3(0, 0, 1));
+        wing.wingSign = sign;
+        wing.color = glm::vec3(1.0f, 1.0f, 0.5f);
+        wing.leaderColor = glm::vec3(1.0f, 0.5f, 0.5f);
+    }
 
-    desired = glm::normalize(desired) * MAX_SPEED;
+    // partPost vai direto para os vértices (e sua transposta inversa para as normais);
+    // partPre é só uma translação, guardada por vértice
+    std::vector<BoidMeshVertex> mesh;
+    mesh.reserve(BOID_MESH_VERTEX_COUNT);
+    boidBoundingRadius = 0.0f;
+    for (const BoidPart& part : parts) {
+        glm::mat3 postNormal = glm::transpose(glm::inverse(glm::mat3(part.post)));
+        for (int v = 0; v < PYRAMID_VERTEX_COUNT; ++v) {
+            const float* src = &pyramidVertices[v * 6];
+            BoidMeshVertex vertex;
+            vertex.position = glm::vec3(part.post * glm::vec4(src[0], src[1], src[2], 1.0f));
+            vertex.normal = postNormal * glm::vec3(src[3], src[4], src[5]);
+            vertex.partOrigin = glm::vec3(part.pre[3]);
+            vertex.wingSign = part.wingSign;
+            vertex.color = part.color;
+            vertex.leaderColor = part.leaderColor;
+            mesh.push_back(vertex);
+            // A batida da asa gira o vértice em torno de partOrigin: a distância até a
+            // origem do boid nunca passa de |partOrigin| + |posição|
+            boidBoundingRadius = std::max(boidBoundingRadius, glm::length(vertex.partOrigin) + glm::length(vertex.position));
+        }
+    }
 
-    glm::vec3 steer = desired - b.velocity;
-    if (glm::length(steer) > MAX_FORCE) {
-        steer = glm::normalize(steer) * MAX_FORCE;
+    // VAO com a malha do boid (atributos 0-1 e 6-9) e os dados por instância (2-5)
+    glGenVertexArrays(1, &VAO_BoidInstanced); glGenBuffers(1, &VBO_BoidInstances); glGenBuffers(1, &VBO_BoidMesh);
+    glBindVertexArray(VAO_BoidInstanced);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_BoidMesh);
+    glBufferData(GL_ARRAY_BUFFER, mesh.size() * sizeof(BoidMeshVertex), mesh.data(), GL_STATIC_DRAW);
+    GLsizei meshStride = sizeof(BoidMeshVertex);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, meshStride, (void*)offsetof(BoidMeshVertex, position));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, meshStride, (void*)offsetof(BoidMeshVertex, normal));
+    glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, meshStride, (void*)offsetof(BoidMeshVertex, partOrigin));
+    glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, meshStride, (void*)offsetof(BoidMeshVertex, wingSign));
+    glVertexAttribPointer(8, 3, GL_FLOAT, GL_FALSE, meshStride, (void*)offsetof(BoidMeshVertex, color));
+    glVertexAttribPointer(9, 3, GL_FLOAT, GL_FALSE, meshStride, (void*)offsetof(BoidMeshVertex, leaderColor));
+    const int meshAttribs[] = { 0, 1, 6, 7, 8, 9 };
+    for (int attrib : meshAttribs) glEnableVertexAttribArray(attrib);
+
+    BindInstanceAttributes(0);
+    for (int attrib = 2; attrib <= 5; ++attrib) {
+        glEnableVertexAttribArray(attrib);
+        glVertexAttribDivisor(attrib, 1);
     }
-    return steer;
+    glBindVertexArray(0);
 }
 
-void UpdateFlock(float dt, bool debugPrint = false) {
-    // --- FÍSICA DO LÍDER (MOVIMENTO SUAVE E RÁPIDO) ---
-    if (glm::length(leaderInputDirection) > 0.0f) {
-        leaderBoid.acceleration = glm::normalize(leaderInputDirection) * LEADER_THRUST;
-    } else {
-        leaderBoid.acceleration = glm::vec3(0.0f);
+// Monta a lista de instâncias do frame interpolando entre o passo anterior e o
+// atual (alpha = fração do próximo passo fixo já decorrida).
+// Bando em [0, n) e líder na última posição, assim a sombra desenha só os n primeiros.
+void BuildBoidInstances(const FlockSoA& prev, const FlockSoA& flock,
+                        const Boid& previousLeader, const Boid& currentLeader, float alpha) {
+    size_t count = flock.Size();
+    // Boids adicionados depois do último passo ainda não têm estado anterior
+    size_t interpolated = std::min(count, prev.Size());
+
+    boidInstances.resize(count + 1);
+    for (size_t i = 0; i < count; ++i) {
+        BoidInstance& inst = boidInstances[i];
+        if (i < interpolated) {
+            inst.position = glm::mix(prev.Position(i), flock.Position(i), alpha);
+            inst.forward = glm::mix(prev.Forward(i), flock.Forward(i), alpha);
+            inst.wingAngle = glm::mix(prev.wingAngle[i], flock.wingAngle[i], alpha);
+        } else {
+            inst.position = flock.Position(i);
+            inst.forward = flock.Forward(i);
+            inst.wingAngle = flock.wingAngle[i];
+        }
+        inst.leader = 0.0f;
     }
 
-    leaderBoid.velocity += leaderBoid.acceleration * dt * 5.0f; // Multiplicador de agilidade
+    BoidInstance& leader = boidInstances[count];
+    leader.position = glm::mix(previousLeader.position, currentLeader.position, alpha);
+    leader.forward = glm::mix(previousLeader.forwardDirection, currentLeader.forwardDirection, alpha);
+    leader.wingAngle = glm::mix(previousLeader.wingAngle, currentLeader.wingAngle, alpha);
+    leader.leader = 1.0f;
+}
 
-    leaderBoid.velocity *= LEADER_DAMPING;
+// O que o frame desenha: as sombras e os boids (líder por último, se visível). Sem
+// nada cortado, as duas listas apontam para boidInstances e vão num upload só.
+struct BoidDrawList {
+    const BoidInstance* shadows;
+    size_t shadowCount;
+    const BoidInstance* boids;
+    size_t boidCount;
+};
 
-    if (glm::length(leaderBoid.velocity) > LEADER_MAX_SPEED) {
-        leaderBoid.velocity = glm::normalize(leaderBoid.velocity) * LEADER_MAX_SPEED;
+// Testa cada boid e sua sombra contra o frustum de viewProjection e monta as listas
+BoidDrawList CullBoidInstances(const glm::mat4& viewProjection) {
+    TRACE_SCOPE("CullBoidInstances");
+    size_t count = boidInstances.size() - 1;
+    BoidDrawList list = { boidInstances.data(), count, boidInstances.data(), count + 1 };
+    hudCulledBoids = 0;
+    hudCulledShadows = 0;
+    if (!frustumCulling || count == 0) return list;
+
+    ScopedTimer cullTimer(cpuProfile.culling);
+    Frustum frustum = Frustum::FromMatrix(viewProjection);
+    PlanarShadow shadow = { LIGHT_POSITION, SHADOW_PLANE_HEIGHT };
+    const float* positions = &boidInstances[0].position.x;
+
+    // Os dois passes usam os mesmos pedaços de CULL_CHUNK, então begin / CULL_CHUNK indexa cullChunks
+    cullFlags.resize(count);
+    cullChunks.assign((count + CULL_CHUNK - 1) / CULL_CHUNK, CullCounts());
+    cullPool.ParallelFor(count, CULL_CHUNK, [&](size_t begin, size_t end) {
+        cullChunks[begin / CULL_CHUNK] = CullBoids(frustum, shadow, boidBoundingRadius, positions,
+                                                   sizeof(BoidInstance), begin, end, cullFlags.data());
+    });
+
+    // Contagens viram o deslocamento de cada pedaço nas listas compactadas
+    size_t visibleBoids = 0, visibleShadows = 0;
+    for (CullCounts& chunk : cullChunks) {
+        CullCounts chunkCounts = chunk;
+        chunk.boids = visibleBoids;
+        chunk.shadows = visibleShadows;
+        visibleBoids += chunkCounts.boids;
+        visibleShadows += chunkCounts.shadows;
     }
-
-    leaderBoid.position += leaderBoid.velocity * dt;
-    if (glm::length(leaderBoid.velocity) > 0.1f)
-        leaderBoid.forwardDirection = glm::normalize(leaderBoid.velocity);
-    leaderBoid.wingAngle += leaderBoid.wingSpeed * dt;
-    // --- FIM DA FÍSICA DO LÍDER ---
-
-
-    // --- FÍSICA DO BANDO ---
-    glm::vec3 centerSum(0.0f);
-    glm::vec3 velocitySum(0.0f);
-
-    for (size_t bi = 0; bi < flock.size(); ++bi) {
-        Boid &b = flock[bi];
-        b.acceleration = glm::vec3(0.0f);
-
-        // --- 1. CÁLCULO DAS FORÇAS DE BANDO E LÍDER ---
-        glm::vec3 separation(0.0f), alignment(0.0f), cohesion(0.0f);
-        int neighbors = 0;
-        for (const auto& other : flock) {
-            if (&b == &other) continue;
-            float dist = glm::distance(b.position, other.position);
-            if (dist < PERCEPTION_RADIUS) {
-                cohesion += other.position;
-                alignment += other.velocity;
-                if (dist < SEPARATION_RADIUS) {
-                    glm::vec3 push = b.position - other.position;
-                    separation += glm::normalize(push) / (dist * dist + 0.01f);
-                }
-                neighbors++;
-            }
+    hudCulledBoids = count - visibleBoids;
+    hudCulledShadows = count - visibleShadows;
+
+    // Só copia a lista que perdeu alguém; a outra continua lendo boidInstances
+    bool compactBoids = visibleBoids < count;
+    bool compactShadows = visibleShadows < count;
+    if (!compactBoids && !compactShadows) return list;
+
+    const BoidInstance& leader = boidInstances[count];
+    bool leaderVisible = frustum.SphereVisible(leader.position, boidBoundingRadius);
+    if (compactBoids) visibleBoidInstances.resize(visibleBoids + (leaderVisible ? 1 : 0));
+    if (compactShadows) visibleShadowInstances.resize(visibleShadows);
+
+    cullPool.ParallelFor(count, CULL_CHUNK, [&](size_t begin, size_t end) {
+        const CullCounts& offset = cullChunks[begin / CULL_CHUNK];
+        BoidInstance* boidOut = compactBoids ? visibleBoidInstances.data() + offset.boids : nullptr;
+        BoidInstance* shadowOut = compactShadows ? visibleShadowInstances.data() + offset.shadows : nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            uint8_t flags = cullFlags[i];
+            if (boidOut && (flags & CULL_BOID_VISIBLE)) *boidOut++ = boidInstances[i];
+            if (shadowOut && (flags & CULL_SHADOW_VISIBLE)) *shadowOut++ = boidInstances[i];
         }
+    });
 
-        glm::vec3 steerAli(0.0f), steerCoh(0.0f), steerSep(0.0f);
-        if (neighbors > 0) {
-            cohesion /= (float)neighbors;
-            steerCoh = SteerTowards(b, cohesion);
-            alignment /= (float)neighbors;
-            alignment = glm::normalize(alignment) * MAX_SPEED;
-            steerAli = alignment - b.velocity;
-            steerAli = limitVector(steerAli, MAX_FORCE);
-            if(glm::length(separation) > 0) {
-                separation = glm::normalize(separation) * MAX_SPEED;
-                steerSep = separation - b.velocity;
-                steerSep = limitVector(steerSep, MAX_FORCE);
-            }
-        }
+    if (compactBoids) {
+        if (leaderVisible) visibleBoidInstances.back() = leader;
+        list.boids = visibleBoidInstances.data();
+        list.boidCount = visibleBoidInstances.size();
+    }
+    if (compactShadows) {
+        list.shadows = visibleShadowInstances.data();
+        list.shadowCount = visibleShadowInstances.size();
+    }
+    return list;
+}
 
-        glm::vec3 steerGoal = SteerTowards(b, leaderBoid.position);
+// Sombras do bando (sempre instanciadas) e, se drawBoids, os boids e o líder
+void DrawFlockInstanced(const BoidDrawList& list, const glm::mat4& view, const glm::mat4& projection, bool drawBoids) {
+    // As sombras são um prefixo dos boids quando as duas listas são boidInstances;
+    // senão vão antes dos boids no mesmo buffer
+    bool shared = list.shadows == list.boids;
+    size_t boidFirst = shared ? 0 : list.shadowCount;
+    size_t shadowBytes = shared ? 0 : list.shadowCount * sizeof(BoidInstance);
+    size_t boidBytes = drawBoids || shared ? list.boidCount * sizeof(BoidInstance) : 0;
+    size_t bytes = shadowBytes + boidBytes;
+
+    // Órfã o buffer antigo para não esperar o frame anterior terminar de usá-lo
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_BoidInstances);
+    if (bytes > boidInstanceCapacity) boidInstanceCapacity = bytes * 2;
+    glBufferData(GL_ARRAY_BUFFER, boidInstanceCapacity, nullptr, GL_STREAM_DRAW);
+    if (shadowBytes > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, shadowBytes, list.shadows);
+    if (boidBytes > 0) glBufferSubData(GL_ARRAY_BUFFER, shadowBytes, boidBytes, list.boids);
+
+    boidShader.use();
+    boidShader.setMat4(boidUniforms.projection, projection);
+    boidShader.setMat4(boidUniforms.view, view);
+    boidShader.setVec3(boidUniforms.lightColor, 1.0f, 1.0f, 1.0f);
+    boidShader.setVec3(boidUniforms.lightPos, LIGHT_POSITION);
+    glm::vec4 shadowPlane(0.0f, 1.0f, 0.0f, -SHADOW_PLANE_HEIGHT);
+    boidShader.setMat4(boidUniforms.shadowProjection, PlanarShadowMatrix(shadowPlane, LIGHT_POSITION));
+
+    glBindVertexArray(VAO_BoidInstanced);
+    for (int pass = 0; pass < (drawBoids ? 2 : 1); ++pass) {
+        // O líder não projeta sombra (e nunca está na lista de sombras)
+        bool shadow = pass == 0;
+        GLsizei instances = (GLsizei)(shadow ? list.shadowCount : list.boidCount);
+        if (instances == 0) continue;
+
+        size_t first = shadow ? 0 : boidFirst;
+        if (first != boidInstanceAttribFirst) BindInstanceAttributes(first);
+        boidShader.setBool(boidUniforms.shadowPass, shadow);
+        boidShader.setBool(boidUniforms.useLighting, !shadow);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, BOID_MESH_VERTEX_COUNT, instances);
+    }
+    glBindVertexArray(0);
+}
 
-        // --- 2. CÁLCULO DAS FORÇAS DE OBSTÁCULO ---
-        glm::vec3 steerFloor(0.0f);
-        if (b.position.y < GROUND_AVOID_HEIGHT) { 
-            glm::vec3 desired = b.velocity;
-            desired.y = MAX_SPEED;
-            steerFloor = desired - b.velocity;
-        }
+// --- COMANDOS DA SIMULAÇÃO ---
+// Com a thread da simulação ativa o comando entra na fila dela; senão é aplicado
+// na hora. Comandos de controle do laço (pausa, passo, ritmo) só importam para a thread.
+void SubmitCommand(const SimCommand& command) {
+    if (simThread.Running()) simThread.Push(command);
+    else sim.Apply(command);
+}
 
-        // --- Cálculo da Força de Obstáculo (Contorno) ---
-        glm::vec3 steerObstacle(0.0f);
-        float distToTowerCenter = glm::length(glm::vec2(b.position.x, b.position.z));
+void SetSimulationThread(bool enabled) {
+    if (enabled == simThread.Running()) return;
+    if (enabled) {
+        simThread.Start(simClock.stepHz, simulationPaused, debugMode);
+    } else {
+        simThread.Stop();
+        // O acumulador da thread principal não deve cobrar o tempo em que ficou parado
+        simClock.Reset();
+    }
+    useSimThread = enabled;
+    std::cout << "[SIM] Simulation thread: " << (enabled ? "ON" : "OFF") << std::endl;
+}
 
-        if (distToTowerCenter < OBSTACLE_AVOID_RADIUS && b.position.y < TOWER_HEIGHT)
-        {
+// --- SNAPSHOTS ---
+// F5 salva e F6 carrega o estado completo da simulação. Com a thread ligada ela é
+// parada antes (só a dona do FlockSimulation pode lê-lo) e religada em seguida.
+std::string snapshotPath;
 
-            glm::vec3 pushDirection = glm::normalize(glm::vec3(b.position.x, 0.0f, b.position.z));
-            float penetration = (OBSTACLE_AVOID_RADIUS - distToTowerCenter);
-            float strength = glm::clamp(penetration / (OBSTACLE_AVOID_RADIUS - TOWER_RADIUS), 0.0f, 1.0f); // Normaliza (0-1)
-            steerObstacle = (pushDirection + glm::vec3(0.0f, 0.3f, 0.0f)) * MAX_SPEED * strength;
-        }
-        // ----------------------------------------------------
-
-        // --- 3. SOMA PONDERADA DE TODAS AS FORÇAS ---
-        b.acceleration += steerSep * WEIGHT_SEPARATION;
-        b.acceleration += steerAli * WEIGHT_ALIGNMENT;
-        b.acceleration += steerCoh * WEIGHT_COHESION;
-        b.acceleration += steerGoal * WEIGHT_GOAL;
-        b.acceleration += steerFloor * WEIGHT_AVOID_FLOOR;
-        b.acceleration += steerObstacle * WEIGHT_AVOID_OBSTACLE; 
-
-        // --- 4. APLICA FÍSICA ---
-        b.acceleration = limitVector(b.acceleration, MAX_FORCE * 2.0f); 
-        b.velocity += b.acceleration * dt * 5.0f;
-        b.velocity = limitVector(b.velocity, MAX_SPEED);
-
-        if (glm::length(b.velocity) < MIN_SPEED)
-             b.velocity = glm::normalize(b.velocity) * MIN_SPEED;
-
-        b.position += b.velocity * dt;
-        b.wingAngle += b.wingSpeed * dt;
-        b.forwardDirection = glm::normalize(b.velocity);
-
-        float distToTower = glm::length(glm::vec2(b.position.x, b.position.z));
-        if (distToTower < (TOWER_RADIUS - 0.2f)) {
-
-            glm::vec3 pushOut = glm::normalize(glm::vec3(b.position.x, 0.0f, b.position.z));
-            b.position.x = pushOut.x * (TOWER_RADIUS + 0.5f);
-            b.position.z = pushOut.z * (TOWER_RADIUS + 0.5f);
-            b.velocity = glm::normalize(glm::vec3(pushOut.x, 0.2f, pushOut.z)) * (MIN_SPEED + 1.0f);
-        }
+void SaveSnapshot() {
+    bool threaded = simThread.Running();
+    SetSimulationThread(false);
+    sim.SaveSnapshotFile(snapshotPath);
+    SetSimulationThread(threaded);
+}
 
-        centerSum += b.position;
-        velocitySum += b.velocity;
-    }
+void StopInputRecording();
 
-    // --- Cálculo Final da Média do Bando (Alvo da Câmera) ---
-    if (!flock.empty()) {
-        flockCenter = centerSum / (float)flock.size();
-        flockAverageVelocity = velocitySum / (float)flock.size();
-    } else {
-        flockCenter = leaderBoid.position;
-        flockAverageVelocity = leaderBoid.velocity;
-    }
+void LoadSnapshot() {
+    bool threaded = simThread.Running();
+    SetSimulationThread(false);
+    // O estado carregado não sai de nenhum comando: o log de entrada termina aqui
+    StopInputRecording();
+    sim.LoadSnapshotFile(snapshotPath);
+    SetSimulationThread(threaded);
+}
 
-    // --- Lógica de Câmera Suave ---
-    float smoothFactor = 1.0f - exp(-dt * CAMERA_SMOOTH_SPEED);
-    smoothFlockCenter = glm::mix(smoothFlockCenter, flockCenter, smoothFactor);
+// --- LOG DE ENTRADA ---
+// F4 liga/desliga. Todo comando (teclado, HUD) e todo passo, na thread que estiver
+// simulando, vão para o log; boids-headless --replay refaz a execução bit a bit.
+InputLog inputLog;
+std::string inputLogPath;
 
-    if (glm::length(flockAverageVelocity) > 0.1f) {
-        smoothFlockVelocity = glm::mix(smoothFlockVelocity, glm::normalize(flockAverageVelocity), smoothFactor);
-    }
+void StopInputRecording() {
+    if (!inputLog.Recording()) return;
+    sim.inputLog = nullptr;
+    inputLog.Stop();
+}
 
-    // --- DEBUG PRINT (opcional) ---
-    if (debugPrint) {
-        std::cout << "DEBUG: flock size = " << flock.size() << ", leader pos = ("
-                  << leaderBoid.position.x << ", " << leaderBoid.position.y << ", " << leaderBoid.position.z << ")\n";
-        size_t limit = std::min((size_t)5, flock.size());
-        for (size_t i = 0; i < limit; ++i) {
-            const Boid &b = flock[i];
-            std::cout << "  Boid[" << i << "] pos=("
-                      << b.position.x << "," << b.position.y << "," << b.position.z
-                      << ") vel=(" << b.velocity.x << "," << b.velocity.y << "," << b.velocity.z << ")\n";
-        }
+void ToggleInputRecording() {
+    bool threaded = simThread.Running();
+    SetSimulationThread(false);
+    if (inputLog.Recording()) {
+        StopInputRecording();
+    } else if (inputLog.Start(inputLogPath, sim)) {
+        sim.inputLog = &inputLog;
     }
+    SetSimulationThread(threaded);
 }
 
+// --- GRAVAÇÃO DE TRAJETÓRIAS ---
+// F7 liga/desliga. A captura roda dentro do Step (na thread que estiver simulando) e só
+// copia os arrays; se o escritor ficar para trás os frames são descartados, nunca o
+// passo espera. O ponteiro em 'sim' só muda com a thread da simulação parada.
+TrajectoryRecorder trajectoryRecorder;
+std::string trajectoryPath;
+
+void ToggleTrajectoryRecording() {
+    bool threaded = simThread.Running();
+    SetSimulationThread(false);
+    if (trajectoryRecorder.Recording()) {
+        sim.recorder = nullptr;
+        trajectoryRecorder.Stop();
+    } else if (trajectoryRecorder.Start(trajectoryPath)) {
+        sim.recorder = &trajectoryRecorder;
+    }
+    SetSimulationThread(threaded);
+}
 
 // --- INPUT ---
 void ProcessInput(GLFWwindow *window) {
-    leaderInputDirection = glm::vec3(0.0f);
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) leaderInputDirection.z -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) leaderInputDirection.z += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) leaderInputDirection.x -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) leaderInputDirection.x += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) leaderInputDirection.y += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) leaderInputDirection.y -= 1.0f;
+    glm::vec3 leaderInput(0.0f);
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) leaderInput.z -= 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) leaderInput.z += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) leaderInput.x -= 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) leaderInput.x += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) leaderInput.y += 1.0f;
+    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) leaderInput.y -= 1.0f;
+
+    // Só envia quando muda, para não encher a fila a cada frame
+    static glm::vec3 lastLeaderInput(0.0f);
+    if (leaderInput != lastLeaderInput || !simThread.Running()) {
+        SubmitCommand(SimCommand(SimCommand::SetLeaderDirection, leaderInput));
+        lastLeaderInput = leaderInput;
+    }
 
     // --- Input da Câmera ---
     if (glfwGetKey(window, GLFW_KEY_0) == GLFW_PRESS) activeCameraMode = 0;
@@ -463,6 +758,7 @@ void ProcessInput(GLFWwindow *window) {
     if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
         if (!btnP) {
             simulationPaused = !simulationPaused;
+            SubmitCommand(SimCommand(SimCommand::SetPaused, simulationPaused ? 1.0f : 0.0f));
             std::cout << "[SIM] Paused: " << (simulationPaused ? "YES" : "NO") << std::endl;
             stepRequested = false;
             stepConsumed = false;
@@ -474,27 +770,116 @@ void ProcessInput(GLFWwindow *window) {
     if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
         if (!btnO) {
             debugMode = !debugMode;
+            SubmitCommand(SimCommand(SimCommand::SetDebugPrint, debugMode ? 1.0f : 0.0f));
             std::cout << "[SIM] Debug mode: " << (debugMode ? "ON" : "OFF") << std::endl;
             btnO = true;
         }
     } else btnO = false;
 
+    static bool btnG = false;
+    if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS) {
+        if (!btnG) {
+            spatialGridEnabled = !spatialGridEnabled;
+            SubmitCommand(SimCommand(SimCommand::SetSpatialGrid, spatialGridEnabled ? 1.0f : 0.0f));
+            std::cout << "[SIM] Spatial grid: " << (spatialGridEnabled ? "ON" : "OFF (brute force)") << std::endl;
+            btnG = true;
+        }
+    } else btnG = false;
+
+    static bool btnI = false;
+    if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) {
+        if (!btnI) {
+            useInstancedBoids = !useInstancedBoids;
+            std::cout << "[SIM] Instanced boids: " << (useInstancedBoids ? "ON" : "OFF") << std::endl;
+            btnI = true;
+        }
+    } else btnI = false;
+
+    static bool btnC = false;
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
+        if (!btnC) {
+            frustumCulling = !frustumCulling;
+            std::cout << "[SIM] Frustum culling: " << (frustumCulling ? "ON" : "OFF") << std::endl;
+            btnC = true;
+        }
+    } else btnC = false;
+
+    static bool btnT = false;
+    if (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) {
+        if (!btnT) {
+            SetSimulationThread(!useSimThread);
+            btnT = true;
+        }
+    } else btnT = false;
+
+#if BOIDS_ENABLE_TRACING
+    static bool btnF8 = false;
+    if (glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS) {
+        if (!btnF8) {
+            Tracer::SetEnabled(!Tracer::Enabled());
+            std::cout << "[SIM] Trace recording: " << (Tracer::Enabled() ? "ON" : "OFF") << std::endl;
+            btnF8 = true;
+        }
+    } else btnF8 = false;
+
+    static bool btnF9 = false;
+    if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS) {
+        if (!btnF9) {
+            DumpTrace();
+            btnF9 = true;
+        }
+    } else btnF9 = false;
+#endif
+
+    static bool btnF4 = false;
+    if (glfwGetKey(window, GLFW_KEY_F4) == GLFW_PRESS) {
+        if (!btnF4) {
+            ToggleInputRecording();
+            btnF4 = true;
+        }
+    } else btnF4 = false;
+
+    static bool btnF5 = false;
+    if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS) {
+        if (!btnF5) {
+            SaveSnapshot();
+            btnF5 = true;
+        }
+    } else btnF5 = false;
+
+    static bool btnF6 = false;
+    if (glfwGetKey(window, GLFW_KEY_F6) == GLFW_PRESS) {
+        if (!btnF6) {
+            LoadSnapshot();
+            btnF6 = true;
+        }
+    } else btnF6 = false;
+
+    static bool btnF7 = false;
+    if (glfwGetKey(window, GLFW_KEY_F7) == GLFW_PRESS) {
+        if (!btnF7) {
+            ToggleTrajectoryRecording();
+            btnF7 = true;
+        }
+    } else btnF7 = false;
+
     static bool btnN = false;
     if (glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS) {
         if (!btnN) {
             stepRequested = true;
             stepConsumed = false;
+            if (simulationPaused) SubmitCommand(SimCommand(SimCommand::SingleStep));
             std::cout << "[SIM] Single-step requested\n";
             btnN = true;
         }
     } else btnN = false;
 
-    // Adicionar/Remover Boids
+    // Adicionar/Remover Boids (aplicados antes do próximo passo)
     static bool btnPlus = false;
     if (glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS) {
         if (!btnPlus) {
-            flock.push_back(Boid(leaderBoid.position + glm::vec3(rand()%5, rand()%5, rand()%5)));
-            std::cout << "[SIM] Added boid, new count = " << flock.size() << std::endl;
+            SubmitCommand(SimCommand(SimCommand::AddBoid));
+            std::cout << "[SIM] Added boid" << std::endl;
             btnPlus = true;
         }
     } else btnPlus = false;
@@ -502,10 +887,8 @@ void ProcessInput(GLFWwindow *window) {
     static bool btnMinus = false;
     if (glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS) {
         if (!btnMinus) {
-            if(!flock.empty()) {
-                flock.pop_back();
-                std::cout << "[SIM] Removed boid, new count = " << flock.size() << std::endl;
-            }
+            SubmitCommand(SimCommand(SimCommand::RemoveBoid));
+            std::cout << "[SIM] Removed boid" << std::endl;
             btnMinus = true;
         }
     } else btnMinus = false;
@@ -513,38 +896,93 @@ void ProcessInput(GLFWwindow *window) {
 
 // --- UPDATE & RENDER ---
 void GameWindow::Update() {
+    TRACE_SCOPE("GameWindow::Update");
     float currentFrame = (float)glfwGetTime();
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
-    if (deltaTime > 0.1f) deltaTime = 0.1f;
+    // No benchmark o tempo simulado não depende do relógio: toda execução desenha a mesma cena
+    if (renderBench.enabled) deltaTime = (float)simClock.StepSeconds();
+    cpuProfile.frame.Add(deltaTime * 1000.0f);
+
+    {
+        TRACE_SCOPE("ProcessInput");
+        ScopedTimer inputTimer(cpuProfile.input);
+        ProcessInput(this->windowHandle);
+    }
+
+    if (simThread.Running()) {
+        // A thread publica no seu ritmo; o frame desenha o snapshot mais novo,
+        // interpolado pelo tempo decorrido desde a publicação
+        const FlockSnapshot& snapshot = simThread.Latest();
+        renderAlpha = simulationPaused ? 1.0f
+            : glm::clamp((float)((SimulationThread::Now() - snapshot.publishedAt) / snapshot.stepSeconds), 0.0f, 1.0f);
+        substepsLastFrame = 0;
+
+        BuildBoidInstances(snapshot.previousFlock, snapshot.flock, snapshot.previousLeader, snapshot.leader, renderAlpha);
+        cameraCenter = glm::mix(snapshot.previousSmoothFlockCenter, snapshot.smoothFlockCenter, renderAlpha);
+        cameraVelocity = glm::mix(snapshot.previousSmoothFlockVelocity, snapshot.smoothFlockVelocity, renderAlpha);
+        hudLeaderPosition = snapshot.leader.position;
+        hudBoidCount = snapshot.flock.Size();
+        hudStepIndex = snapshot.stepIndex;
+        hudStepMilliseconds = snapshot.stepMilliseconds;
+        if (snapshot.stepIndex != profiledStepIndex) {
+            AddStepTimings(snapshot.timings);
+            profiledStepIndex = snapshot.stepIndex;
+        }
 
-    ProcessInput(this->windowHandle);
+        ReloadChangedShaders();
+        return;
+    }
 
+    // O custo da simulação por segundo depende só de simClock.stepHz, não do FPS
+    substepsLastFrame = 0;
     if (simulationPaused) {
         if (stepRequested && !stepConsumed) {
-            UpdateFlock(deltaTime, debugMode); 
+            sim.Step(simClock.StepSeconds(), debugMode);
+            AddStepTimings(sim.lastStepTimings);
             stepConsumed = true;
+            substepsLastFrame = 1;
         }
+        renderAlpha = 1.0f;
     } else {
-        UpdateFlock(deltaTime, false);       
+        substepsLastFrame = simClock.Advance(deltaTime);
+        for (int i = 0; i < substepsLastFrame; ++i) {
+            sim.Step(simClock.StepSeconds(), false);
+            AddStepTimings(sim.lastStepTimings);
+        }
+        renderAlpha = simClock.Alpha();
     }
 
-    s.ReloadFromFile();
+    BuildBoidInstances(sim.PreviousFlock(), sim.Flock(), sim.previousLeader, sim.leader, renderAlpha);
+    cameraCenter = glm::mix(sim.previousSmoothFlockCenter, sim.smoothFlockCenter, renderAlpha);
+    cameraVelocity = glm::mix(sim.previousSmoothFlockVelocity, sim.smoothFlockVelocity, renderAlpha);
+    hudLeaderPosition = sim.leader.position;
+    hudBoidCount = sim.Flock().Size();
+
+    ReloadChangedShaders();
 }
 
 void GameWindow::Render() {
+    TRACE_SCOPE("GameWindow::Render");
+    Stopwatch sceneTimer;
+    if (renderBench.enabled) GlCallCounter::Reset();
+    gpuProfile.sky.Collect();
+    gpuProfile.ground.Collect();
+    gpuProfile.tower.Collect();
+    gpuProfile.boids.Collect();
+
     glClearColor(0.10f, 0.20f, 0.45f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     if (skyProgram != 0) {
+        gpuProfile.sky.Begin();
 
         glDisable(GL_DEPTH_TEST);
         glDepthMask(GL_FALSE);
 
         glUseProgram(skyProgram);
 
-        int u_mode = glGetUniformLocation(skyProgram, "u_mode");
-        if (u_mode != -1) glUniform1i(u_mode, 0);
+        if (skyModeLocation != -1) glUniform1i(skyModeLocation, 0);
 
         glBindVertexArray(skyQuadVAO);
         glDrawArrays(GL_TRIANGLES, 0, 3);
@@ -552,6 +990,7 @@ void GameWindow::Render() {
 
         glDepthMask(GL_TRUE);
         glEnable(GL_DEPTH_TEST);
+        gpuProfile.sky.End();
     }
 
     ImGui_ImplOpenGL3_NewFrame();
@@ -559,20 +998,20 @@ void GameWindow::Render() {
     ImGui::NewFrame();
 
     s.use();
-    s.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
-    s.setVec3("lightPos", 0.0f, 150.0f, 100.0f);
+    s.setVec3(sceneUniforms.lightColor, 1.0f, 1.0f, 1.0f);
+    s.setVec3(sceneUniforms.lightPos, LIGHT_POSITION);
 
     glm::mat4 projection =
         glm::perspective(glm::radians(45.0f),
                          (float)SCR_WIDTH / (float)SCR_HEIGHT,
                          0.1f, 500.0f);
-    s.setMat4("projection", projection);
+    s.setMat4(sceneUniforms.projection, projection);
 
     // --- câmera ---
     glm::mat4 view;
-    glm::vec3 center = smoothFlockCenter;
+    glm::vec3 center = cameraCenter;
     glm::vec3 up(0.0f, 1.0f, 0.0f);
-    glm::vec3 avgFlockDir = smoothFlockVelocity;
+    glm::vec3 avgFlockDir = cameraVelocity;
 
     if (glm::length(avgFlockDir) < 0.1f)
         avgFlockDir = glm::vec3(0, 0, 1);
@@ -610,49 +1049,59 @@ void GameWindow::Render() {
             break;
         }
     }
-    s.setMat4("view", view);
+    s.setMat4(sceneUniforms.view, view);
     // --- fim da câmera ---
 
     // --- chão ---
-    s.setBool("useLighting", true);
-    s.setMat4("model", glm::mat4(1.0f));
-    s.setVec3("objectColor", 0.2f, 0.4f, 0.2f);
+    gpuProfile.ground.Begin();
+    s.setBool(sceneUniforms.useLighting, true);
+    s.setMat4(sceneUniforms.model, glm::mat4(1.0f));
+    s.setMat3(sceneUniforms.normalMatrix, glm::mat3(1.0f));
+    s.setVec3(sceneUniforms.objectColor, 0.2f, 0.4f, 0.2f);
     glBindVertexArray(VAO_Floor);
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
+    // --- grid suave (logo após o chão, para os dois caberem num só timer de GPU) ---
+    s.setBool(sceneUniforms.useLighting, false);
+    s.setVec3(sceneUniforms.objectColor, 0.1f, 0.15f, 0.1f); // bem discreto
+    glBindVertexArray(VAO_Grid);
+    glDrawArrays(GL_LINES, 0, gridVertexCount);
+    gpuProfile.ground.End();
+
     // --- torre ---
-    s.setVec3("objectColor", 0.0f, 0.05f, 0.2f);
+    gpuProfile.tower.Begin();
+    s.setBool(sceneUniforms.useLighting, true);
+    s.setVec3(sceneUniforms.objectColor, 0.0f, 0.05f, 0.2f);
     glBindVertexArray(VAO_Cone);
     glDrawArrays(GL_TRIANGLES, 0, coneVertexCount);
+    gpuProfile.tower.End();
 
-    // --- grid suave ---
-    s.setBool("useLighting", false);
-    s.setVec3("objectColor", 0.1f, 0.15f, 0.1f); // bem discreto
-    glBindVertexArray(VAO_Grid);
-    glDrawArrays(GL_LINES, 0, gridVertexCount);
+    // --- só o que a câmera ativa enxerga ---
+    BoidDrawList drawList = CullBoidInstances(projection * view);
 
-    // --- boid líder ---
-    s.setBool("useLighting", true);
-    glm::mat4 leaderM = calculateOrientation(leaderBoid.position, leaderBoid.forwardDirection);
-    DrawBoidParts(leaderBoid, leaderM, true, true);
+    gpuProfile.boids.Begin();
 
-    // --- boids ---
-    for (const auto& b : flock) {
-        glm::vec3 shadowPos = b.position;
-        shadowPos.y = 0.05f;
-        glm::mat4 shadowMatrix = calculateOrientation(shadowPos, b.forwardDirection);
-        shadowMatrix = glm::scale(shadowMatrix, glm::vec3(1.0f, 0.05f, 1.0f));
-
-        s.setBool("useLighting", false);
-        s.setVec3("objectColor", 0.0f, 0.0f, 0.0f);
-        DrawBoidParts(b, shadowMatrix, false, false);
+    if (useInstancedBoids) {
+        // --- boids, líder e sombras em chamadas instanciadas ---
+        DrawFlockInstanced(drawList, view, projection, true);
+    } else {
+        // --- boids e líder (o último da lista, se visível) ---
+        s.setBool(sceneUniforms.useLighting, true);
+        for (size_t i = 0; i < drawList.boidCount; ++i) {
+            const BoidInstance& boid = drawList.boids[i];
+            glm::mat4 boidM = calculateOrientation(boid.position, boid.forward);
+            DrawBoidParts(boid.wingAngle, boidM, boid.leader > 0.5f, true);
+        }
 
-        s.setBool("useLighting", true);
-        glm::mat4 boidM = calculateOrientation(b.position, b.forwardDirection);
-        DrawBoidParts(b, boidM, false, true);
+        // --- sombras: uma única chamada instanciada também neste modo ---
+        DrawFlockInstanced(drawList, view, projection, false);
     }
 
+    gpuProfile.boids.End();
+    cpuProfile.scene.Add(sceneTimer.Milliseconds());
+
     // HUD / Debug window
+    Stopwatch imguiTimer;
     ImGui::SetNextWindowSize(ImVec2(250, 0), ImGuiCond_Always);
     ImGui::SetNextWindowSizeConstraints(
         ImVec2(250, 0),
@@ -669,43 +1118,160 @@ void GameWindow::Render() {
         default: camMode = "Debug Fixa (0)"; break;
     }
     ImGui::Text("Camera: %s", camMode.c_str());
-    ImGui::Text("Boids: %d", (int)flock.size());
+    ImGui::Text("Boids: %d", (int)hudBoidCount);
     ImGui::Text("Simulation: %s", simulationPaused ? "PAUSED" : "RUNNING");
     ImGui::Text("Debug Mode: %s", debugMode ? "ON" : "OFF");
     ImGui::Text("Step requested: %s", stepRequested ? "YES" : "NO");
+    if (ImGui::Checkbox("Spatial grid (G)", &spatialGridEnabled)) {
+        SubmitCommand(SimCommand(SimCommand::SetSpatialGrid, spatialGridEnabled ? 1.0f : 0.0f));
+    }
+    ImGui::Checkbox("Instanced boids (I)", &useInstancedBoids);
+    ImGui::Checkbox("Frustum culling (C)", &frustumCulling);
+    ImGui::Text("Culled: %d boids, %d shadows", (int)hudCulledBoids, (int)hudCulledShadows);
+    if (ImGui::SliderInt("Threads", &simThreadCount, 1, (int)ThreadPool::HardwareThreads())) {
+        SubmitCommand(SimCommand(SimCommand::SetThreadCount, (float)simThreadCount));
+    }
+    const char* kernelNames[] = { "Scalar", "SSE4", "AVX2" };
+    if (ImGui::Combo("Kernel", &steeringKernel, kernelNames, 3)) {
+        if (!SteeringKernelSupported((SteeringKernel)steeringKernel)) steeringKernel = (int)BestSteeringKernel();
+        SubmitCommand(SimCommand(SimCommand::SetSteeringKernel, (float)steeringKernel));
+    }
+    bool threadToggle = useSimThread;
+    if (ImGui::Checkbox("Simulation thread (T)", &threadToggle)) {
+        SetSimulationThread(threadToggle);
+    }
+    if (ImGui::SliderFloat("Sim Hz", &simClock.stepHz, 10.0f, 240.0f, "%.0f")) {
+        SubmitCommand(SimCommand(SimCommand::SetStepHz, simClock.stepHz));
+    }
+    if (simThread.Running()) {
+        ImGui::Text("Sim step: %llu  %.2f ms  alpha: %.2f", hudStepIndex, hudStepMilliseconds, renderAlpha);
+    } else {
+        ImGui::SliderInt("Max substeps", &simClock.maxSubsteps, 1, 16);
+        ImGui::Text("Substeps: %d  alpha: %.2f  dropped: %lld", substepsLastFrame, renderAlpha, simClock.droppedSteps);
+    }
     ImGui::Text("Leader Pos: %.1f %.1f %.1f",
-        leaderBoid.position.x,
-        leaderBoid.position.y,
-        leaderBoid.position.z);
+        hudLeaderPosition.x,
+        hudLeaderPosition.y,
+        hudLeaderPosition.z);
     ImGui::Text("Bando (Alvo): %.1f %.1f %.1f",
-        smoothFlockCenter.x,
-        smoothFlockCenter.y,
-        smoothFlockCenter.z);
+        cameraCenter.x,
+        cameraCenter.y,
+        cameraCenter.z);
 
     if (ImGui::Button("Add Boid (+)")) {
-        flock.push_back(Boid(leaderBoid.position + glm::vec3(rand()%5, rand()%5, rand()%5)));
+        SubmitCommand(SimCommand(SimCommand::AddBoid));
     }
     ImGui::SameLine();
     if (ImGui::Button("Remove Boid (-)")) {
-        if (!flock.empty()) flock.pop_back();
+        SubmitCommand(SimCommand(SimCommand::RemoveBoid));
+    }
+
+    // Tamanho do bando: o slider acompanha a contagem real e só envia ao soltar
+    const char* shapeNames[] = { "Sphere", "Box", "Ring" };
+    ImGui::Combo("Spawn shape", &spawnShape, shapeNames, 3);
+    static bool editingTarget = false;
+    if (!editingTarget) targetBoidCount = (int)hudBoidCount;
+    ImGui::SliderInt("Target boids", &targetBoidCount, 0, MAX_TARGET_BOIDS, "%d", ImGuiSliderFlags_Logarithmic);
+    editingTarget = ImGui::IsItemActive();
+    if (ImGui::IsItemDeactivatedAfterEdit()) {
+        SubmitCommand(SimCommand(SimCommand::SetTargetCount, (float)targetBoidCount, (SpawnShape)spawnShape));
+    }
+    if (ImGui::Button("Spawn 1000")) {
+        SubmitCommand(SimCommand(SimCommand::SpawnBoids, glm::vec3(0.0f), (float)SPAWN_BATCH, (SpawnShape)spawnShape));
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Despawn 1000")) {
+        SubmitCommand(SimCommand(SimCommand::DespawnBoids, (float)SPAWN_BATCH));
+    }
+
+    if (ImGui::Button("Save snapshot (F5)")) SaveSnapshot();
+    ImGui::SameLine();
+    if (ImGui::Button("Load snapshot (F6)")) LoadSnapshot();
+
+    bool recordingInput = inputLog.Recording();
+    if (ImGui::Checkbox("Record input log (F4)", &recordingInput)) ToggleInputRecording();
+    if (recordingInput) ImGui::Text("  %llu steps", (unsigned long long)inputLog.StepCount());
+
+    bool recording = trajectoryRecorder.Recording();
+    if (ImGui::Checkbox("Record trajectories (F7)", &recording)) ToggleTrajectoryRecording();
+    if (recording) {
+        ImGui::Text("  %llu frames, %llu dropped, %.1f MiB",
+                    (unsigned long long)trajectoryRecorder.FramesCaptured(),
+                    (unsigned long long)trajectoryRecorder.FramesDropped(),
+                    trajectoryRecorder.BytesWritten() / (1024.0 * 1024.0));
+    }
+
+#if BOIDS_ENABLE_TRACING
+    bool tracing = Tracer::Enabled();
+    if (ImGui::Checkbox("Record trace (F8)", &tracing)) Tracer::SetEnabled(tracing);
+    ImGui::SameLine();
+    if (ImGui::Button("Dump (F9)")) DumpTrace();
+#endif
+
+    if (ImGui::CollapsingHeader("Profiler")) {
+        ImGui::TextDisabled("CPU ms (min / avg / p99)");
+        PlotTiming("Frame", cpuProfile.frame);
+        PlotTiming("Input", cpuProfile.input);
+        PlotTiming("UpdateFlock", cpuProfile.simTotal);
+        PlotTiming("  Neighbor search", cpuProfile.simNeighbors);
+        PlotTiming("  Integration", cpuProfile.simIntegration);
+        PlotTiming("Scene submission", cpuProfile.scene);
+        PlotTiming("  Frustum culling", cpuProfile.culling);
+        PlotTiming("ImGui", cpuProfile.imgui);
+        PlotTiming("SwapBuffers", cpuProfile.swap);
+        ImGui::TextDisabled("GPU ms (min / avg / p99)");
+        PlotTiming("Sky", gpuProfile.sky.history);
+        PlotTiming("Ground", gpuProfile.ground.history);
+        PlotTiming("Tower", gpuProfile.tower.history);
+        PlotTiming("Boids", gpuProfile.boids.history);
     }
 
     ImGui::Separator();
-    ImGui::TextWrapped("Controls: P = Pause/Unpause (while paused N = single-step).\n+ / - or buttons to add/remove boids during pause or run.");
+    ImGui::TextWrapped("Controls: P = Pause/Unpause (while paused N = single-step).\n+ / - or buttons to add/remove boids during pause or run.\nG = toggle spatial grid / brute-force neighbor search.\nI = toggle instanced / per-boid rendering.\nC = toggle frustum culling.\nT = run the simulation on its own thread.\nF4 = record input log, F5 = save snapshot, F6 = load snapshot, F7 = record trajectories.\nF8 = record trace, F9 = dump trace JSON.");
     ImGui::End();
 
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-    glfwSwapBuffers(windowHandle);
+    cpuProfile.imgui.Add(imguiTimer.Milliseconds());
+    float submitMs = sceneTimer.Milliseconds();
+
+    Stopwatch finishTimer;
+    {
+        TRACE_SCOPE("SwapBuffers");
+        ScopedTimer swapTimer(cpuProfile.swap);
+        glfwSwapBuffers(windowHandle);
+    }
+
+    if (renderBench.enabled) {
+        // Espera o frame terminar para o próximo não herdar trabalho pendente do driver
+        glFinish();
+        if (renderBenchFrame >= renderBench.warmupFrames) {
+            RenderBenchFrame frame;
+            frame.submitMs = submitMs;
+            frame.finishMs = finishTimer.Milliseconds();
+            frame.calls = GlCallCounter::Stats();
+            renderBenchReport.Add(frame);
+        }
+        if (++renderBenchFrame >= renderBench.warmupFrames + renderBench.frames)
+            glfwSetWindowShouldClose(windowHandle, GLFW_TRUE);
+    }
     glfwPollEvents();
 }
 
 // --- BOILERPLATE ---
 
+void GameWindow::ConfigurePlatform() {
+    if (renderBench.enabled && renderBench.offscreen) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+}
+
 void GameWindow::Initialize() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (renderBench.enabled) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        if (renderBench.offscreen) glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    }
 }
 
 // --- LOAD CONTENT ---
@@ -715,21 +1281,79 @@ void GameWindow::LoadContent() {
 
     s = Shader::LoadShader("resources/shaders/testing.vs", "resources/shaders/testing.fs");
     CreateCommonGeometry();
+    boidShader = Shader::LoadShader("resources/shaders/boid.vs", "resources/shaders/boid.fs");
+
+    sceneUniforms.model = s.GetUniformHandle("model");
+    sceneUniforms.normalMatrix = s.GetUniformHandle("normalMatrix");
+    sceneUniforms.view = s.GetUniformHandle("view");
+    sceneUniforms.projection = s.GetUniformHandle("projection");
+    sceneUniforms.objectColor = s.GetUniformHandle("objectColor");
+    sceneUniforms.lightColor = s.GetUniformHandle("lightColor");
+    sceneUniforms.lightPos = s.GetUniformHandle("lightPos");
+    sceneUniforms.useLighting = s.GetUniformHandle("useLighting");
+    const Shader* watchedShaders[] = { &s, &boidShader };
+    for (const Shader* shader : watchedShaders) {
+        shaderWatcher.Watch(shader->vertexFile);
+        shaderWatcher.Watch(shader->fragmentFile);
+    }
+    shaderWatcher.Start();
+    shaderCompiler.Start(windowHandle);
+
+    boidUniforms.view = boidShader.GetUniformHandle("view");
+    boidUniforms.projection = boidShader.GetUniformHandle("projection");
+    boidUniforms.lightColor = boidShader.GetUniformHandle("lightColor");
+    boidUniforms.lightPos = boidShader.GetUniformHandle("lightPos");
+    boidUniforms.useLighting = boidShader.GetUniformHandle("useLighting");
+    boidUniforms.shadowPass = boidShader.GetUniformHandle("shadowPass");
+    boidUniforms.shadowProjection = boidShader.GetUniformHandle("shadowProjection");
+
+    CreateBoidInstancing();
+    cullPool.Resize(ThreadPool::HardwareThreads());
+    gpuProfile.sky.Create();
+    gpuProfile.ground.Create();
+    gpuProfile.tower.Create();
+    gpuProfile.boids.Create();
     glEnable(GL_DEPTH_TEST);
 
     // ALTERADO: Posição inicial do líder movida para fora da torre (que tem raio 15)
-    leaderBoid.position = glm::vec3(0, 15, TOWER_RADIUS + 15.0f); // 15 + 15 = 30
-
-    smoothFlockCenter = leaderBoid.position;
-
-    flock.clear();
-    for(int i = 0; i < 20; i++) {
-        float angle = (float)i / 10.0f * 6.28f;
-        glm::vec3 offset(cos(angle)*2.0f, 0.0f, sin(angle)*2.0f);
-        flock.push_back(Boid(leaderBoid.position + offset));
+    sim.leader.position = glm::vec3(0, 15, TOWER_RADIUS + 15.0f); // 15 + 15 = 30
+
+    sim.smoothFlockCenter = sim.leader.position;
+    sim.ResetInterpolation();
+
+    // Bando inicial em anel ao redor do líder
+    sim.Clear();
+    SpawnParams initialFlock;
+    initialFlock.shape = SpawnShape::Ring;
+    initialFlock.center = sim.leader.position;
+    initialFlock.radius = 2.0f;
+    initialFlock.count = (size_t)targetBoidCount;
+
+    if (renderBench.enabled) {
+        // Cena fixa: mesma semente e bando em esfera, sem vsync; contadores de chamadas GL ligados
+        sim.Seed(renderBench.seed);
+        initialFlock.shape = SpawnShape::Sphere;
+        initialFlock.radius = 0.0f;
+        initialFlock.count = (size_t)renderBench.boids;
+        useInstancedBoids = renderBench.instanced;
+        frustumCulling = renderBench.frustumCulling;
+        activeCameraMode = renderBench.camera;
+        glfwSwapInterval(0);
+
+        const char* renderer = (const char*)glGetString(GL_RENDERER);
+        renderBenchReport.renderer = renderer ? renderer : "unknown";
+        renderBenchReport.scene = std::to_string(renderBench.boids) + " boids, "
+            + (renderBench.instanced ? "instanced" : "per-boid") + ", seed " + std::to_string(renderBench.seed)
+            + ", camera " + std::to_string(renderBench.camera) + (renderBench.frustumCulling ? ", culled" : ", no culling");
+        GlCallCounter::Install();
     }
-
-    flock.push_back(Boid(leaderBoid.position + glm::vec3(rand()%5, rand()%5, rand()%5)));
+    snapshotPath = snapshotFile;
+    // Com --snapshot o bando salvo substitui o inicial (se o arquivo não carregar, fica o anel)
+    if (!loadSnapshot || !sim.LoadSnapshotFile(snapshotPath)) sim.Spawn(initialFlock);
+    trajectoryPath = trajectoryFile;
+    if (recordTrajectory) ToggleTrajectoryRecording();
+    inputLogPath = inputLogFile;
+    if (recordInput) ToggleInputRecording();
 
     
     // --- Cria fullscreen triangle (sky) e programa simples para gradiente azul ---
@@ -758,6 +1382,7 @@ void GameWindow::LoadContent() {
     )";
 
     skyProgram = CreateProgramFromSrc(skyVS, skyFS);
+    skyModeLocation = glGetUniformLocation(skyProgram, "u_mode");
 
     float quadVerts[] = {
         -1.0f, -1.0f,
@@ -775,10 +1400,30 @@ void GameWindow::LoadContent() {
 }
 
 void GameWindow::Unload() {
+    SetSimulationThread(false);
+    sim.recorder = nullptr;
+    trajectoryRecorder.Stop();
+    StopInputRecording();
+    shaderWatcher.Stop();
+    shaderCompiler.Stop();
+    if (Tracer::EventCount() > 0) DumpTrace();
+
+    if (renderBench.enabled) {
+        GlCallCounter::Uninstall();
+        renderBenchReport.Print();
+        if (!renderBench.outFile.empty()) renderBenchReport.WriteJson(renderBench.outFile);
+    }
+
     glDeleteVertexArrays(1, &VAO_Floor); glDeleteBuffers(1, &VBO_Floor);
     glDeleteVertexArrays(1, &VAO_Grid);  glDeleteBuffers(1, &VBO_Grid);
     glDeleteVertexArrays(1, &VAO_Cone);  glDeleteBuffers(1, &VBO_Cone);
     glDeleteVertexArrays(1, &VAO_Pyramid); glDeleteBuffers(1, &VBO_Pyramid);
+    glDeleteVertexArrays(1, &VAO_BoidInstanced); glDeleteBuffers(1, &VBO_BoidInstances); glDeleteBuffers(1, &VBO_BoidMesh);
+    boidShader.Unload();
+    gpuProfile.sky.Destroy();
+    gpuProfile.ground.Destroy();
+    gpuProfile.tower.Destroy();
+    gpuProfile.boids.Destroy();
 
     if (skyQuadVAO) glDeleteVertexArrays(1, &skyQuadVAO);
     if (skyQuadVBO) glDeleteBuffers(1, &skyQuadVBO);
@@ -0,0 +1,140 @@
+#include "display/gl_call_stats.hpp"
+#include "glad.h"
+
+namespace {
+
+GlCallStats stats = {};
+bool installed = false;
+
+// Declares real_<fn> (the driver entry point) and counted_<fn>, which bumps one
+// counter and forwards. The name is only ever pasted with ##, so glad's
+// "#define glFoo glad_glFoo" never expands it.
+#define GL_COUNTED(fn, counter, params, args)              \
+    decltype(glad_##fn) real_##fn = nullptr;               \
+    void APIENTRY counted_##fn params {                    \
+        stats.counter++;                                   \
+        real_##fn args;                                    \
+    }
+
+GL_COUNTED(glDrawArrays, drawCalls, (GLenum mode, GLint first, GLsizei count), (mode, first, count))
+GL_COUNTED(glDrawArraysInstanced, drawCalls, (GLenum mode, GLint first, GLsizei count, GLsizei instances),
+           (mode, first, count, instances))
+GL_COUNTED(glDrawElements, drawCalls, (GLenum mode, GLsizei count, GLenum type, const void* indices),
+           (mode, count, type, indices))
+GL_COUNTED(glDrawElementsBaseVertex, drawCalls,
+           (GLenum mode, GLsizei count, GLenum type, const void* indices, GLint baseVertex),
+           (mode, count, type, indices, baseVertex))
+
+GL_COUNTED(glUniform1i, uniformUpdates, (GLint location, GLint v0), (location, v0))
+GL_COUNTED(glUniform1f, uniformUpdates, (GLint location, GLfloat v0), (location, v0))
+GL_COUNTED(glUniform3f, uniformUpdates, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2))
+GL_COUNTED(glUniform3fv, uniformUpdates, (GLint location, GLsizei count, const GLfloat* value), (location, count, value))
+GL_COUNTED(glUniform4fv, uniformUpdates, (GLint location, GLsizei count, const GLfloat* value), (location, count, value))
+GL_COUNTED(glUniformMatrix3fv, uniformUpdates,
+           (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value), (location, count, transpose, value))
+GL_COUNTED(glUniformMatrix4fv, uniformUpdates,
+           (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value), (location, count, transpose, value))
+
+GL_COUNTED(glUseProgram, programBinds, (GLuint program), (program))
+GL_COUNTED(glBindVertexArray, vertexArrayBinds, (GLuint array), (array))
+GL_COUNTED(glBindBuffer, bufferBinds, (GLenum target, GLuint buffer), (target, buffer))
+GL_COUNTED(glBindTexture, textureBinds, (GLenum target, GLuint texture), (target, texture))
+GL_COUNTED(glEnable, capabilityToggles, (GLenum cap), (cap))
+GL_COUNTED(glDisable, capabilityToggles, (GLenum cap), (cap))
+
+#undef GL_COUNTED
+
+// Uploads also count bytes; a glBufferData without data only (re)allocates
+decltype(glad_glBufferData) real_glBufferData = nullptr;
+void APIENTRY counted_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    if (data) {
+        stats.bufferUploads++;
+        stats.bufferUploadBytes += (uint64_t)size;
+    }
+    real_glBufferData(target, size, data, usage);
+}
+
+decltype(glad_glBufferSubData) real_glBufferSubData = nullptr;
+void APIENTRY counted_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    stats.bufferUploads++;
+    stats.bufferUploadBytes += (uint64_t)size;
+    real_glBufferSubData(target, offset, size, data);
+}
+
+// Mapped writes are uploads too (the ImGui backend streams its vertices this way)
+decltype(glad_glMapBufferRange) real_glMapBufferRange = nullptr;
+void* APIENTRY counted_glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    if (access & GL_MAP_WRITE_BIT) {
+        stats.bufferUploads++;
+        stats.bufferUploadBytes += (uint64_t)length;
+    }
+    return real_glMapBufferRange(target, offset, length, access);
+}
+
+// Applies 'hook' to every wrapped entry point
+template <typename Hook>
+void ForEachHook(Hook hook) {
+#define GL_HOOK(fn) hook(glad_##fn, real_##fn, counted_##fn)
+    GL_HOOK(glDrawArrays);
+    GL_HOOK(glDrawArraysInstanced);
+    GL_HOOK(glDrawElements);
+    GL_HOOK(glDrawElementsBaseVertex);
+    GL_HOOK(glUniform1i);
+    GL_HOOK(glUniform1f);
+    GL_HOOK(glUniform3f);
+    GL_HOOK(glUniform3fv);
+    GL_HOOK(glUniform4fv);
+    GL_HOOK(glUniformMatrix3fv);
+    GL_HOOK(glUniformMatrix4fv);
+    GL_HOOK(glUseProgram);
+    GL_HOOK(glBindVertexArray);
+    GL_HOOK(glBindBuffer);
+    GL_HOOK(glBindTexture);
+    GL_HOOK(glEnable);
+    GL_HOOK(glDisable);
+    GL_HOOK(glBufferData);
+    GL_HOOK(glBufferSubData);
+    GL_HOOK(glMapBufferRange);
+#undef GL_HOOK
+}
+
+struct InstallHook {
+    template <typename Fn>
+    void operator()(Fn& glad, Fn& real, Fn counted) const {
+        // Entry points the context does not expose stay null
+        if (!glad || glad == counted) return;
+        real = glad;
+        glad = counted;
+    }
+};
+
+struct UninstallHook {
+    template <typename Fn>
+    void operator()(Fn& glad, Fn& real, Fn counted) const {
+        if (glad == counted) glad = real;
+    }
+};
+
+}
+
+void GlCallCounter::Install() {
+    ForEachHook(InstallHook());
+    installed = true;
+}
+
+void GlCallCounter::Uninstall() {
+    ForEachHook(UninstallHook());
+    installed = false;
+}
+
+bool GlCallCounter::Installed() {
+    return installed;
+}
+
+void GlCallCounter::Reset() {
+    stats = GlCallStats();
+}
+
+GlCallStats GlCallCounter::Stats() {
+    return stats;
+}
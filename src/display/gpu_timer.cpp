@@ -0,0 +1,45 @@
+#include "display/gpu_timer.hpp"
+#include "glad.h"
+
+GpuTimer::GpuTimer() : queries(), oldest(0), inFlight(0), active(false) {
+
+}
+
+void GpuTimer::Create() {
+    glGenQueries(QUERY_COUNT, queries);
+    oldest = 0;
+    inFlight = 0;
+}
+
+void GpuTimer::Destroy() {
+    if (queries[0] != 0) glDeleteQueries(QUERY_COUNT, queries);
+    for (int i = 0; i < QUERY_COUNT; ++i) queries[i] = 0;
+}
+
+void GpuTimer::Begin() {
+    // Every query still in flight (GPU more than QUERY_COUNT frames behind): skip this sample
+    active = queries[0] != 0 && inFlight < QUERY_COUNT;
+    if (!active) return;
+    glBeginQuery(GL_TIME_ELAPSED, queries[(oldest + inFlight) % QUERY_COUNT]);
+}
+
+void GpuTimer::End() {
+    if (!active) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    inFlight++;
+    active = false;
+}
+
+void GpuTimer::Collect() {
+    while (inFlight > 0) {
+        GLint available = 0;
+        glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &nanoseconds);
+        history.Add((float)(nanoseconds / 1.0e6));
+        oldest = (oldest + 1) % QUERY_COUNT;
+        inFlight--;
+    }
+}
@@ -0,0 +1,114 @@
+#include "display/render_bench.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+struct Summary {
+    double mean, min, p50, p95, max;
+};
+
+Summary Summarize(std::vector<float> samples) {
+    Summary s = {};
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (float v : samples) sum += v;
+    size_t last = samples.size() - 1;
+    s.mean = sum / samples.size();
+    s.min = samples.front();
+    s.p50 = samples[last / 2];
+    s.p95 = samples[(last * 95) / 100];
+    s.max = samples.back();
+    return s;
+}
+
+// Per-frame averages of every counter
+struct CallAverages {
+    double drawCalls, uniformUpdates, programBinds, vertexArrayBinds, bufferBinds;
+    double textureBinds, capabilityToggles, bufferUploads, bufferUploadBytes;
+};
+
+CallAverages AverageCalls(const std::vector<RenderBenchFrame>& frames) {
+    CallAverages a = {};
+    if (frames.empty()) return a;
+    for (const RenderBenchFrame& f : frames) {
+        a.drawCalls += f.calls.drawCalls;
+        a.uniformUpdates += f.calls.uniformUpdates;
+        a.programBinds += f.calls.programBinds;
+        a.vertexArrayBinds += f.calls.vertexArrayBinds;
+        a.bufferBinds += f.calls.bufferBinds;
+        a.textureBinds += f.calls.textureBinds;
+        a.capabilityToggles += f.calls.capabilityToggles;
+        a.bufferUploads += f.calls.bufferUploads;
+        a.bufferUploadBytes += f.calls.bufferUploadBytes;
+    }
+    double n = (double)frames.size();
+    a.drawCalls /= n; a.uniformUpdates /= n; a.programBinds /= n;
+    a.vertexArrayBinds /= n; a.bufferBinds /= n; a.textureBinds /= n;
+    a.capabilityToggles /= n; a.bufferUploads /= n; a.bufferUploadBytes /= n;
+    return a;
+}
+
+std::vector<float> Column(const std::vector<RenderBenchFrame>& frames, float RenderBenchFrame::*field) {
+    std::vector<float> out;
+    out.reserve(frames.size());
+    for (const RenderBenchFrame& f : frames) out.push_back(f.*field);
+    return out;
+}
+
+void WriteSummary(FILE* file, const char* name, const Summary& s) {
+    fprintf(file, "  \"%s\": {\"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"max\": %.4f},\n",
+            name, s.mean, s.min, s.p50, s.p95, s.max);
+}
+
+// Renderer names come from the driver; keep the JSON valid whatever they contain
+void WriteEscaped(FILE* file, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') fputc('\\', file);
+        if ((unsigned char)c >= 0x20) fputc(c, file);
+    }
+}
+
+}
+
+void RenderBenchReport::Print() const {
+    Summary submit = Summarize(Column(frames, &RenderBenchFrame::submitMs));
+    Summary finish = Summarize(Column(frames, &RenderBenchFrame::finishMs));
+    CallAverages calls = AverageCalls(frames);
+
+    std::cout << "INFO::RENDER_BENCH::" << frames.size() << " frames on " << renderer << " (" << scene << ")\n";
+    printf("  CPU submission ms: mean %.3f  p50 %.3f  p95 %.3f  max %.3f\n", submit.mean, submit.p50, submit.p95, submit.max);
+    printf("  swap + finish ms:  mean %.3f  p50 %.3f  p95 %.3f  max %.3f\n", finish.mean, finish.p50, finish.p95, finish.max);
+    printf("  per frame: %.1f draw calls, %.1f uniform updates, %.1f program binds, %.1f VAO binds\n",
+           calls.drawCalls, calls.uniformUpdates, calls.programBinds, calls.vertexArrayBinds);
+    printf("             %.1f buffer uploads (%.1f KiB), %.1f enable/disable\n",
+           calls.bufferUploads, calls.bufferUploadBytes / 1024.0, calls.capabilityToggles);
+}
+
+bool RenderBenchReport::WriteJson(const std::string& path) const {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::RENDER_BENCH::COULD_NOT_OPEN_FILE " << path << std::endl;
+        return false;
+    }
+
+    CallAverages calls = AverageCalls(frames);
+    fputs("{\n  \"benchmark\": \"render-submission\",\n  \"renderer\": \"", file);
+    WriteEscaped(file, renderer);
+    fputs("\",\n  \"scene\": \"", file);
+    WriteEscaped(file, scene);
+    fprintf(file, "\",\n  \"frames\": %zu,\n", frames.size());
+    WriteSummary(file, "submit_ms", Summarize(Column(frames, &RenderBenchFrame::submitMs)));
+    WriteSummary(file, "finish_ms", Summarize(Column(frames, &RenderBenchFrame::finishMs)));
+    fprintf(file, "  \"per_frame\": {\"draw_calls\": %.2f, \"uniform_updates\": %.2f, \"program_binds\": %.2f, "
+                  "\"vertex_array_binds\": %.2f, \"buffer_binds\": %.2f, \"texture_binds\": %.2f, "
+                  "\"capability_toggles\": %.2f, \"buffer_uploads\": %.2f, \"buffer_upload_bytes\": %.1f}\n}\n",
+            calls.drawCalls, calls.uniformUpdates, calls.programBinds, calls.vertexArrayBinds, calls.bufferBinds,
+            calls.textureBinds, calls.capabilityToggles, calls.bufferUploads, calls.bufferUploadBytes);
+    fclose(file);
+
+    std::cout << "INFO::RENDER_BENCH::WROTE " << path << std::endl;
+    return true;
+}
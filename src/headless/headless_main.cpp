@@ -0,0 +1,282 @@
+// boids-headless: roda a simulação do bando sem janela nem contexto OpenGL.
+// Útil em máquinas de CI sem GPU e para execuções longas offline.
+//
+// Uso: boids-headless [--boids N] [--steps N] [--dt S] [--seed N] [--threads N] [--brute]
+//                      [--kernel scalar|sse4|avx2] [--validate] [--trace FILE]
+//                      [--load SNAPSHOT] [--save SNAPSHOT] [--record TRAJECTORY]
+//                      [--record-input LOG] [--replay LOG [--verbose]]
+// --load começa do estado salvo (ignora --boids e --seed); --save grava o estado final
+// --record grava posição e velocidade de todo boid em cada passo (trajectory_recorder.hpp)
+// --record-input grava o log de entrada da execução; --replay refaz um log (input_log.hpp)
+// a partir do estado e da configuração gravados nele (só --threads ainda vale) e falha
+// se algum checksum divergir
+#include "simulation/flock_simulation.hpp"
+#include "simulation/input_log.hpp"
+#include "simulation/trajectory_recorder.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+struct HeadlessOptions {
+    int boids = 1000;
+    int steps = 1000;
+    float dt = 1.0f / 60.0f;
+    uint64_t seed = 1;
+    int threads = (int)ThreadPool::HardwareThreads();
+    bool bruteForce = false;
+    SteeringKernel kernel = BestSteeringKernel();
+    // Compara os kernels SIMD com o escalar no estado inicial e final
+    bool validate = false;
+    std::string traceFile;
+    std::string loadFile;
+    std::string saveFile;
+    std::string recordFile;
+    std::string inputLogFile;
+    std::string replayFile;
+    bool threadsGiven = false;
+    bool verbose = false;
+};
+
+static void PrintUsage() {
+    std::cout << "Usage: boids-headless [--boids N] [--steps N] [--dt S] [--seed N] [--threads N] [--brute]\n"
+              << "                      [--kernel scalar|sse4|avx2] [--validate] [--trace FILE]\n"
+              << "                      [--load SNAPSHOT] [--save SNAPSHOT] [--record TRAJECTORY]\n"
+              << "                      [--record-input LOG] [--replay LOG [--verbose]]\n";
+}
+
+static bool ParseOptions(int argc, char** argv, HeadlessOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--boids" && hasValue) opt.boids = atoi(argv[++i]);
+        else if (arg == "--steps" && hasValue) opt.steps = atoi(argv[++i]);
+        else if (arg == "--dt" && hasValue) opt.dt = (float)atof(argv[++i]);
+        else if (arg == "--seed" && hasValue) opt.seed = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--threads" && hasValue) {
+            opt.threads = atoi(argv[++i]);
+            opt.threadsGiven = true;
+        }
+        else if (arg == "--brute") opt.bruteForce = true;
+        else if (arg == "--trace" && hasValue) opt.traceFile = argv[++i];
+        else if (arg == "--validate") opt.validate = true;
+        else if (arg == "--load" && hasValue) opt.loadFile = argv[++i];
+        else if (arg == "--save" && hasValue) opt.saveFile = argv[++i];
+        else if (arg == "--record" && hasValue) opt.recordFile = argv[++i];
+        else if (arg == "--record-input" && hasValue) opt.inputLogFile = argv[++i];
+        else if (arg == "--replay" && hasValue) opt.replayFile = argv[++i];
+        else if (arg == "--verbose") opt.verbose = true;
+        else if (arg == "--kernel" && hasValue) {
+            std::string name = argv[++i];
+            if (name == "scalar") opt.kernel = SteeringKernel::Scalar;
+            else if (name == "sse4") opt.kernel = SteeringKernel::SSE4;
+            else if (name == "avx2") opt.kernel = SteeringKernel::AVX2;
+            else {
+                PrintUsage();
+                return false;
+            }
+            if (!SteeringKernelSupported(opt.kernel)) {
+                std::cout << "ERROR::HEADLESS::kernel " << name << " is not supported on this CPU" << std::endl;
+                return false;
+            }
+        }
+        else {
+            PrintUsage();
+            return false;
+        }
+    }
+    return opt.boids >= 0 && opt.steps >= 0 && opt.dt > 0.0f && opt.threads >= 1;
+}
+
+// Espalha os boids num cubo ao redor do líder, com ~1 boid a cada SEPARATION_RADIUS³
+static void SpawnFlock(FlockSimulation& sim, int count) {
+    sim.leader.position = glm::vec3(0, 15, TOWER_RADIUS + 15.0f);
+    sim.smoothFlockCenter = sim.leader.position;
+    sim.ResetInterpolation();
+
+    float side = SEPARATION_RADIUS * std::cbrt((float)count);
+    sim.Clear();
+    sim.Reserve(count);
+
+    SpawnParams params;
+    params.shape = SpawnShape::Box;
+    params.center = sim.leader.position + glm::vec3(0.0f, 0.5f * side, 0.0f);
+    params.radius = 0.5f * side;
+    params.count = (size_t)count;
+    sim.Spawn(params);
+}
+
+// Roda cada kernel SIMD suportado sobre os mesmos candidatos da grade e compara com o
+// escalar. As somas só podem diferir por arredondamento (ordem de soma, d² vs d);
+// a contagem de vizinhos pode mudar apenas para pares exatamente na borda do raio.
+static bool ValidateKernels(const FlockSimulation& sim, const char* label) {
+    const float TOLERANCE = 1e-4f;
+    const FlockSoA& flock = sim.Flock();
+    SpatialGrid grid;
+    grid.Build(PERCEPTION_RADIUS, flock.px, flock.py, flock.pz);
+
+    auto relativeError = [](glm::vec3 a, glm::vec3 b) {
+        return glm::length(a - b) / std::max(1.0f, glm::length(a));
+    };
+
+    bool ok = true;
+    std::vector<int> candidates;
+    const SteeringKernel kernels[] = { SteeringKernel::SSE4, SteeringKernel::AVX2 };
+    for (SteeringKernel kernel : kernels) {
+        if (!SteeringKernelSupported(kernel)) continue;
+        SteeringKernelFn simd = SelectSteeringKernel(kernel);
+
+        float maxError = 0.0f;
+        size_t countMismatches = 0;
+        for (size_t i = 0; i < flock.Size(); ++i) {
+            grid.Query(flock.Position(i), candidates);
+            NeighborSums expected, actual;
+            GatherNeighborsScalar(flock, i, candidates.data(), candidates.size(), expected);
+            simd(flock, i, candidates.data(), candidates.size(), actual);
+
+            if (expected.count != actual.count) {
+                countMismatches++;
+                continue;
+            }
+            maxError = std::max(maxError, relativeError(expected.cohesion, actual.cohesion));
+            maxError = std::max(maxError, relativeError(expected.alignment, actual.alignment));
+            maxError = std::max(maxError, relativeError(expected.separation, actual.separation));
+        }
+
+        bool passed = maxError <= TOLERANCE && countMismatches * 1000 <= flock.Size();
+        printf("validate %s (%s): max relative error %.3g, neighbor count mismatches %zu -> %s\n",
+               SteeringKernelName(kernel), label, maxError, countMismatches, passed ? "OK" : "FAIL");
+        ok = ok && passed;
+    }
+    return ok;
+}
+
+// Fecha a gravação e confere o último frame decodificado contra o estado final
+static bool VerifyRecording(TrajectoryRecorder& recorder, const std::string& path, const FlockSimulation& sim) {
+    recorder.Stop();
+    TrajectoryReader reader;
+    TrajectoryFrame frame;
+    if (!reader.Open(path) || reader.FrameCount() == 0 || !reader.ReadFrame(reader.FrameCount() - 1, frame)) {
+        std::cout << "ERROR::HEADLESS::cannot read back " << path << std::endl;
+        return false;
+    }
+
+    const FlockSoA& flock = sim.Flock();
+    bool sameIds = frame.ids == sim.SlotIds();
+    float positionError = 0.0f, velocityError = 0.0f;
+    for (size_t i = 0; sameIds && i < frame.Size(); ++i) {
+        positionError = std::max(positionError, glm::length(glm::vec3(frame.px[i], frame.py[i], frame.pz[i]) - flock.Position(i)));
+        velocityError = std::max(velocityError, glm::length(glm::vec3(frame.vx[i], frame.vy[i], frame.vz[i]) - flock.Velocity(i)));
+    }
+    printf("trajectory: %llu frames in %zu blocks, last frame max error: position %.3g, velocity %.3g%s\n",
+           (unsigned long long)reader.FrameCount(), reader.BlockCount(), positionError, velocityError,
+           sameIds ? "" : " (IDS DIFFER)");
+    return sameIds;
+}
+
+int main(int argc, char** argv) {
+    HeadlessOptions opt;
+    if (!ParseOptions(argc, argv, opt)) return 1;
+
+    // Todo sorteio do spawn vem do gerador da simulação: a semente fixa a execução
+    FlockSimulation sim;
+    sim.Seed(opt.seed);
+    sim.threadCount = opt.threads;
+    sim.useSpatialGrid = !opt.bruteForce;
+    sim.steeringKernel = opt.kernel;
+    InputReplay replay;
+    if (!opt.replayFile.empty()) {
+        InputReplayOptions replayOptions;
+        replayOptions.threads = opt.threadsGiven ? opt.threads : 0;
+        replayOptions.verbose = opt.verbose;
+        if (!replay.Open(opt.replayFile, sim, replayOptions)) return 1;
+        opt.boids = (int)sim.Flock().Size();
+        opt.seed = sim.seed;
+        opt.steps = (int)replay.StepCount();
+        opt.threads = sim.threadCount;
+        opt.bruteForce = !sim.useSpatialGrid;
+        opt.kernel = sim.steeringKernel;
+    } else if (opt.loadFile.empty()) {
+        SpawnFlock(sim, opt.boids);
+    } else {
+        if (!sim.LoadSnapshotFile(opt.loadFile)) return 1;
+        opt.boids = (int)sim.Flock().Size();
+        opt.seed = sim.seed;
+    }
+
+    std::cout << "INFO::HEADLESS::boids=" << opt.boids << " steps=" << opt.steps << " dt=" << opt.dt
+              << " seed=" << opt.seed << " threads=" << opt.threads
+              << " neighbors=" << (opt.bruteForce ? "brute-force" : "grid")
+              << " kernel=" << SteeringKernelName(opt.kernel) << std::endl;
+    printf("initial checksum: %016llx\n", sim.Checksum());
+    bool valid = !opt.validate || ValidateKernels(sim, "initial");
+
+    Tracer::SetThreadName("main");
+    if (!opt.traceFile.empty()) {
+        if (BOIDS_ENABLE_TRACING) Tracer::SetEnabled(true);
+        else std::cout << "ERROR::HEADLESS::built without BOIDS_ENABLE_TRACING, --trace ignored" << std::endl;
+    }
+
+    // Execução offline: nenhum frame pode faltar, então se o escritor ficar para trás
+    // (mais de queueFrames passos) o laço espera por ele em vez de descartar
+    TrajectoryRecorder recorder;
+    if (!opt.recordFile.empty()) {
+        TrajectoryRecorderOptions recordOptions;
+        recordOptions.waitWhenFull = true;
+        if (!recorder.Start(opt.recordFile, recordOptions)) return 1;
+        sim.recorder = &recorder;
+    }
+
+    InputLog inputLog;
+    if (!opt.inputLogFile.empty()) {
+        if (!inputLog.Start(opt.inputLogFile, sim)) return 1;
+        sim.inputLog = &inputLog;
+    }
+
+    InputReplayResult replayed;
+    auto start = std::chrono::steady_clock::now();
+    if (!opt.replayFile.empty()) {
+        if (!replay.Run(sim, replayed)) return 1;
+    } else {
+        for (int step = 0; step < opt.steps; ++step) {
+            sim.Step(opt.dt);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    sim.recorder = nullptr;
+    sim.inputLog = nullptr;
+    if (!opt.inputLogFile.empty() && !inputLog.Stop()) valid = false;
+    if (!opt.recordFile.empty() && !VerifyRecording(recorder, opt.recordFile, sim)) valid = false;
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    double stepsPerSecond = seconds > 0.0 ? opt.steps / seconds : 0.0;
+    double nsPerBoidStep = (opt.steps > 0 && opt.boids > 0) ? seconds * 1e9 / ((double)opt.steps * opt.boids) : 0.0;
+    printf("elapsed: %.3f s, %.1f steps/s, %.3f ms/step, %.1f ns/boid/step\n",
+           seconds, stepsPerSecond, opt.steps > 0 ? seconds * 1000.0 / opt.steps : 0.0, nsPerBoidStep);
+    printf("flock center: %.4f %.4f %.4f\n", sim.flockCenter.x, sim.flockCenter.y, sim.flockCenter.z);
+    printf("final checksum: %016llx\n", sim.Checksum());
+    if (!opt.replayFile.empty()) {
+        if (replayed.diverged) {
+            printf("replay: DIVERGED, checksum after step %llu differs (%llu earlier checksums matched)\n",
+                   (unsigned long long)replayed.divergedAtStep, (unsigned long long)replayed.checksumsVerified);
+            valid = false;
+        } else {
+            printf("replay: %llu steps, %llu commands, %llu checksums match (recorded final %016llx)\n",
+                   (unsigned long long)replayed.steps, (unsigned long long)replayed.commands,
+                   (unsigned long long)replayed.checksumsVerified, replay.FinalChecksum());
+        }
+        printf("replay: %.3f ms/step inside Step, slowest step %llu (%.3f ms)\n",
+               replayed.steps > 0 ? replayed.stepSeconds * 1000.0 / replayed.steps : 0.0,
+               (unsigned long long)replayed.slowestStep, replayed.slowestStepMilliseconds);
+    }
+    if (opt.validate) valid = ValidateKernels(sim, "final") && valid;
+    if (!opt.saveFile.empty() && !sim.SaveSnapshotFile(opt.saveFile)) valid = false;
+
+    if (Tracer::Enabled()) Tracer::WriteJson(opt.traceFile);
+    return valid ? 0 : 1;
+}
@@ -6,6 +6,7 @@
 // Implemented features:
 //  [X] Renderer: User texture binding. Use 'GLuint' OpenGL texture identifier as void*/ImTextureID. Read the FAQ about ImTextureID!
 //  [x] Renderer: Desktop GL only: Support for large meshes (64k+ vertices) with 16-bit indices.
+//  [x] Renderer: Desktop GL 3.2+: Streams all draw lists of a frame into one ring buffer with a single mapped upload.
 
 // You can copy and use unmodified imgui_impl_* files in your project. See examples/ folder for examples of using this.
 // If you are new to Dear ImGui, read documentation from the docs/ folder + read the top of imgui.cpp.
@@ -139,6 +140,11 @@ using namespace gl;
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_BIND_SAMPLER
 #endif
 
+// Desktop GL 3.2+ has glMapBufferRange() and fence syncs, which the streaming ring buffer needs
+#if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_VERSION_3_2)
+#define IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+#endif
+
 // Desktop GL 3.1+ has GL_PRIMITIVE_RESTART state
 #if !defined(IMGUI_IMPL_OPENGL_ES2) && !defined(IMGUI_IMPL_OPENGL_ES3) && defined(GL_VERSION_3_1)
 #define IMGUI_IMPL_OPENGL_MAY_HAVE_PRIMITIVE_RESTART
@@ -153,6 +159,24 @@ static GLint        g_AttribLocationTex = 0, g_AttribLocationProjMtx = 0;
 static GLuint       g_AttribLocationVtxPos = 0, g_AttribLocationVtxUV = 0, g_AttribLocationVtxColor = 0; // Vertex attributes location
 static unsigned int g_VboHandle = 0, g_ElementsHandle = 0;
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+// Streaming ring buffers: g_VboHandle/g_ElementsHandle are allocated once (and regrown when a
+// frame no longer fits a third of them) instead of re-specified per draw list with glBufferData.
+// Every frame appends all its vertices/indices in one unsynchronized mapping and fences the range;
+// the writer only waits when it wraps around onto a range the GPU may still be reading.
+struct ImGui_ImplOpenGL3_StreamRing {
+    unsigned int    Capacity;   // In elements (ImDrawVert or ImDrawIdx), so offsets are always element aligned
+    unsigned int    Head;
+};
+struct ImGui_ImplOpenGL3_StreamFence {
+    GLsync          Sync;
+    unsigned int    VtxBegin, VtxEnd, IdxBegin, IdxEnd;
+};
+static bool                                     g_UseStreamingBuffers = true;
+static ImGui_ImplOpenGL3_StreamRing             g_VtxRing = { 0, 0 }, g_IdxRing = { 0, 0 };
+static ImVector<ImGui_ImplOpenGL3_StreamFence>  g_StreamFences;    // Oldest first
+#endif
+
 // Functions
 bool    ImGui_ImplOpenGL3_Init(const char* glsl_version) {
     // Query for GL version (e.g. 320 for GL 3.2)
@@ -310,6 +334,114 @@ static void ImGui_ImplOpenGL3_SetupRenderState(ImDrawData* draw_data, int fb_wid
     glVertexAttribPointer(g_AttribLocationVtxColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)IM_OFFSETOF(ImDrawVert, col));
 }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+static void ImGui_ImplOpenGL3_WaitStreamFences(int count) {
+    for (int i = 0; i < count; i++) {
+        // Flush on the first try so the fence can't sit forever in an unsubmitted batch
+        GLenum result = glClientWaitSync(g_StreamFences[i].Sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while (result == GL_TIMEOUT_EXPIRED)
+            result = glClientWaitSync(g_StreamFences[i].Sync, 0, 1000000); // 1 ms
+        glDeleteSync(g_StreamFences[i].Sync);
+    }
+    if (count > 0)
+        g_StreamFences.erase(g_StreamFences.begin(), g_StreamFences.begin() + count);
+}
+
+static void ImGui_ImplOpenGL3_ResetStreamRings() {
+    for (int i = 0; i < g_StreamFences.Size; i++)
+        glDeleteSync(g_StreamFences[i].Sync);
+    g_StreamFences.clear();
+    g_VtxRing.Capacity = g_VtxRing.Head = 0;
+    g_IdxRing.Capacity = g_IdxRing.Head = 0;
+}
+
+static unsigned int ImGui_ImplOpenGL3_RingAlloc(ImGui_ImplOpenGL3_StreamRing& ring, unsigned int count) {
+    // Ranges never straddle the end: wrap to the start instead
+    if (ring.Head + count > ring.Capacity)
+        ring.Head = 0;
+    unsigned int begin = ring.Head;
+    ring.Head += count;
+    return begin;
+}
+
+static bool ImGui_ImplOpenGL3_RangesOverlap(unsigned int a_begin, unsigned int a_end, unsigned int b_begin, unsigned int b_end) {
+    return a_begin < b_end && b_begin < a_end;
+}
+
+// Copies every draw list of the frame into the rings (both buffers must be bound).
+// Returns false if mapping failed, in which case the caller uploads per list as before.
+static bool ImGui_ImplOpenGL3_StreamDrawData(ImDrawData* draw_data, unsigned int* out_vtx_begin, unsigned int* out_idx_begin) {
+    unsigned int vtx_count = (unsigned int)draw_data->TotalVtxCount;
+    unsigned int idx_count = (unsigned int)draw_data->TotalIdxCount;
+    *out_vtx_begin = *out_idx_begin = 0;
+    if (vtx_count == 0 || idx_count == 0)
+        return true;
+
+    // Keep room for about three frames in flight; regrowing orphans the old storage, which the
+    // driver keeps alive for draws still reading it, so the old fences can simply be dropped.
+    if (vtx_count * 3 > g_VtxRing.Capacity || idx_count * 3 > g_IdxRing.Capacity) {
+        unsigned int vtx_capacity = g_VtxRing.Capacity ? g_VtxRing.Capacity : 16384;
+        unsigned int idx_capacity = g_IdxRing.Capacity ? g_IdxRing.Capacity : 32768;
+        while (vtx_count * 3 > vtx_capacity) vtx_capacity *= 2;
+        while (idx_count * 3 > idx_capacity) idx_capacity *= 2;
+        ImGui_ImplOpenGL3_ResetStreamRings();
+        g_VtxRing.Capacity = vtx_capacity;
+        g_IdxRing.Capacity = idx_capacity;
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vtx_capacity * (int)sizeof(ImDrawVert), NULL, GL_STREAM_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)idx_capacity * (int)sizeof(ImDrawIdx), NULL, GL_STREAM_DRAW);
+    }
+
+    unsigned int vtx_begin = ImGui_ImplOpenGL3_RingAlloc(g_VtxRing, vtx_count);
+    unsigned int idx_begin = ImGui_ImplOpenGL3_RingAlloc(g_IdxRing, idx_count);
+
+    // Retire what the GPU already finished, then wait (oldest first) for anything still reading our ranges
+    int must_wait = 0;
+    for (int i = 0; i < g_StreamFences.Size; i++) {
+        const ImGui_ImplOpenGL3_StreamFence& fence = g_StreamFences[i];
+        if (ImGui_ImplOpenGL3_RangesOverlap(vtx_begin, vtx_begin + vtx_count, fence.VtxBegin, fence.VtxEnd) ||
+            ImGui_ImplOpenGL3_RangesOverlap(idx_begin, idx_begin + idx_count, fence.IdxBegin, fence.IdxEnd))
+            must_wait = i + 1;
+    }
+    int retire = must_wait;
+    while (retire < g_StreamFences.Size && glClientWaitSync(g_StreamFences[retire].Sync, 0, 0) != GL_TIMEOUT_EXPIRED)
+        retire++;
+    ImGui_ImplOpenGL3_WaitStreamFences(retire);
+
+    const GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    ImDrawVert* vtx_dst = (ImDrawVert*)glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)vtx_begin * (int)sizeof(ImDrawVert), (GLsizeiptr)vtx_count * (int)sizeof(ImDrawVert), map_flags);
+    ImDrawIdx* idx_dst = vtx_dst ? (ImDrawIdx*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)idx_begin * (int)sizeof(ImDrawIdx), (GLsizeiptr)idx_count * (int)sizeof(ImDrawIdx), map_flags) : NULL;
+    if (idx_dst) {
+        for (int n = 0; n < draw_data->CmdListsCount; n++) {
+            const ImDrawList* cmd_list = draw_data->CmdLists[n];
+            memcpy(vtx_dst, cmd_list->VtxBuffer.Data, (size_t)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+            memcpy(idx_dst, cmd_list->IdxBuffer.Data, (size_t)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+            vtx_dst += cmd_list->VtxBuffer.Size;
+            idx_dst += cmd_list->IdxBuffer.Size;
+        }
+    }
+    // glUnmapBuffer() returns GL_FALSE if the storage got corrupted while mapped (e.g. mode switch)
+    bool ok = vtx_dst != NULL && idx_dst != NULL;
+    if (idx_dst && glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_FALSE) ok = false;
+    if (vtx_dst && glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE) ok = false;
+    if (!ok) {
+        ImGui_ImplOpenGL3_ResetStreamRings();
+        return false;
+    }
+
+    *out_vtx_begin = vtx_begin;
+    *out_idx_begin = idx_begin;
+    return true;
+}
+#endif
+
+void ImGui_ImplOpenGL3_SetStreamingBuffers(bool enabled) {
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    g_UseStreamingBuffers = enabled;
+#else
+    IM_UNUSED(enabled);
+#endif
+}
+
 // OpenGL3 Render function.
 // Note that this implementation is little overcomplicated because we are saving/setting up/restoring every OpenGL state explicitly.
 // This is in order to be able to run within an OpenGL engine that doesn't do so.
@@ -366,13 +498,26 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data) {
     ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
     ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
+    // Upload every list at once into the streaming rings when we can (needs base vertex draws),
+    // after which lists are only offsets into them
+    bool streaming = false;
+    unsigned int global_vtx_offset = 0, global_idx_offset = 0;
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    if (g_UseStreamingBuffers && g_GlVersion >= 320)
+        streaming = ImGui_ImplOpenGL3_StreamDrawData(draw_data, &global_vtx_offset, &global_idx_offset);
+    else if (g_VtxRing.Capacity != 0)
+        ImGui_ImplOpenGL3_ResetStreamRings(); // The per-list glBufferData below replaces the ring storage
+#endif
+
     // Render command lists
     for (int n = 0; n < draw_data->CmdListsCount; n++)     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
 
         // Upload vertex/index buffers
-        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+        if (!streaming)         {
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * (int)sizeof(ImDrawVert), (const GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * (int)sizeof(ImDrawIdx), (const GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+        }
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)         {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
@@ -400,15 +545,32 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data) {
                     glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID());
 #ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_VTX_OFFSET
                     if (g_GlVersion >= 320)
-                        glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)), (GLint)pcmd->VtxOffset);
+                        glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)((global_idx_offset + pcmd->IdxOffset) * sizeof(ImDrawIdx)), (GLint)(global_vtx_offset + pcmd->VtxOffset));
                     else
 #endif
                         glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (void*)(intptr_t)(pcmd->IdxOffset * sizeof(ImDrawIdx)));
                 }
             }
         }
+        if (streaming)         {
+            global_vtx_offset += (unsigned int)cmd_list->VtxBuffer.Size;
+            global_idx_offset += (unsigned int)cmd_list->IdxBuffer.Size;
+        }
     }
 
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    // Fence this frame's ranges so the ring won't overwrite them before the GPU is done
+    if (streaming && draw_data->TotalVtxCount > 0 && draw_data->TotalIdxCount > 0)     {
+        ImGui_ImplOpenGL3_StreamFence fence;
+        fence.Sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        fence.VtxEnd = global_vtx_offset;
+        fence.VtxBegin = global_vtx_offset - (unsigned int)draw_data->TotalVtxCount;
+        fence.IdxEnd = global_idx_offset;
+        fence.IdxBegin = global_idx_offset - (unsigned int)draw_data->TotalIdxCount;
+        g_StreamFences.push_back(fence);
+    }
+#endif
+
     // Destroy the temporary VAO
 #ifndef IMGUI_IMPL_OPENGL_ES2
     glDeleteVertexArrays(1, &vertex_array_object);
@@ -689,6 +851,9 @@ bool    ImGui_ImplOpenGL3_CreateDeviceObjects() {
 }
 
 void    ImGui_ImplOpenGL3_DestroyDeviceObjects() {
+#ifdef IMGUI_IMPL_OPENGL_MAY_HAVE_STREAMING
+    ImGui_ImplOpenGL3_ResetStreamRings();
+#endif
     if (g_VboHandle) { glDeleteBuffers(1, &g_VboHandle); g_VboHandle = 0; }
     if (g_ElementsHandle) { glDeleteBuffers(1, &g_ElementsHandle); g_ElementsHandle = 0; }
     if (g_ShaderHandle && g_VertHandle) { glDetachShader(g_ShaderHandle, g_VertHandle); }
@@ -1,7 +1,51 @@
 #include "display/game_window.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
 
-int main() {
+// Uso: boids-simulacao [--snapshot FILE] [--record FILE] [--record-input FILE]
+//                       [--render-bench [--frames N] [--warmup N] [--boids N] [--seed N]
+//                       [--per-boid] [--camera N] [--no-cull] [--offscreen] [--out FILE]]
+static bool ParseOptions(int argc, char** argv, GameWindow& gw) {
+    RenderBenchOptions& opt = gw.renderBench;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--render-bench") opt.enabled = true;
+        else if (arg == "--frames" && hasValue) opt.frames = atoi(argv[++i]);
+        else if (arg == "--warmup" && hasValue) opt.warmupFrames = atoi(argv[++i]);
+        else if (arg == "--boids" && hasValue) opt.boids = atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) opt.seed = strtoull(argv[++i], NULL, 10);
+        else if (arg == "--per-boid") opt.instanced = false;
+        else if (arg == "--camera" && hasValue) opt.camera = atoi(argv[++i]);
+        else if (arg == "--no-cull") opt.frustumCulling = false;
+        else if (arg == "--offscreen") opt.offscreen = true;
+        else if (arg == "--out" && hasValue) opt.outFile = argv[++i];
+        else if (arg == "--snapshot" && hasValue) {
+            gw.snapshotFile = argv[++i];
+            gw.loadSnapshot = true;
+        }
+        else if (arg == "--record" && hasValue) {
+            gw.trajectoryFile = argv[++i];
+            gw.recordTrajectory = true;
+        }
+        else if (arg == "--record-input" && hasValue) {
+            gw.inputLogFile = argv[++i];
+            gw.recordInput = true;
+        }
+        else {
+            std::cout << "Usage: boids-simulacao [--snapshot FILE] [--record FILE] [--record-input FILE]\n"
+                      << "                        [--render-bench [--frames N] [--warmup N] [--boids N] [--seed N]\n"
+                      << "                        [--per-boid] [--camera N] [--no-cull] [--offscreen] [--out FILE]]\n";
+            return false;
+        }
+    }
+    return opt.frames > 0 && opt.warmupFrames >= 0 && opt.boids >= 0 && opt.camera >= 0 && opt.camera <= 3;
+}
+
+int main(int argc, char** argv) {
 
 GameWindow gw = GameWindow{ 800, 600, "Simulação de Boids – Trabalho Prático" };
+    if (!ParseOptions(argc, argv, gw)) return 1;
     return gw.Run();
-}
\ No newline at end of file
+}
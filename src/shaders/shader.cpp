@@ -1,7 +1,10 @@
 #include "shaders/shader.hpp"
+#include "shaders/shader_compiler.hpp"
+#include "utils/file_watcher.hpp"
 #include "utils/utility.hpp"
+#include "utils/trace.hpp"
 
-Shader::Shader() {
+Shader::Shader() : programID(0), fileVersionOnLoad(0), pendingBuild(0), pendingVersion(0) {
 
 }
 
@@ -10,160 +13,179 @@ void Shader::Unload() {
     glDeleteProgram(this->programID);
 }
 
-void Shader::ReloadFromFile() {
-    // Get the current modified time for the fragment shader file
-    long currentModTime = GetFileModTime(this->fragmentFile);
-
-    // If the current modified time is LATER than the previously set modified time
-    if (currentModTime > fragmentModTimeOnLoad) {
-        // Unload current shader
-        this->Unload();
-
-        // Load new shader using the same files, however, the fragment file 
-        // will contain new code this time
-        Shader s = Shader::LoadShader(this->vertexFile, this->fragmentFile);
-
-        // Discard newly loaded shader, but persist the shader program id it created during loading
-        this->programID = s.programID;
-        // Set the latest fragment file modified time to the current time
-        this->fragmentModTimeOnLoad = currentModTime;
+void Shader::ReloadFromFile(const FileWatcher& watcher, ShaderCompiler& compiler) {
+    TRACE_SCOPE("Shader::ReloadFromFile");
+    // One build at a time; edits made meanwhile are picked up once it lands
+    if (pendingBuild == 0) {
+        SubmitIfChanged(watcher, compiler);
+        if (pendingBuild == 0) return;
     }
-}
-
-bool Shader::CompileShader(unsigned int shaderId, char(&infoLog)[512]) {
-    // This assumes that you have already appended the source code to the shader
-    // Attempts to compile the shader
-    glCompileShader(shaderId);
 
-    // Get the compile status from the shader
-    int success;
-    glGetShaderiv(shaderId, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        // If it didn't succeed, then fill infoLog with error msg.
-        glGetShaderInfoLog(shaderId, 512, NULL, infoLog);
+    unsigned int newProgramID = 0;
+    if (!compiler.Collect(pendingBuild, newProgramID)) {
+        // Still compiling: keep drawing with the current program
+        return;
+    }
+    pendingBuild = 0;
+    // A failed build isn't retried until one of the files changes again
+    fileVersionOnLoad = pendingVersion;
+
+    if (newProgramID == 0) {
+        std::cout << "ERROR::SHADER[" << this->programID << "](" << this->vertexFile << " + " << this->fragmentFile << ")::RELOAD_FAILED keeping the previous program" << std::endl;
+    } else {
+        // The old program may still be referenced by queued draws; GL frees it once they're done
+        this->Unload();
+        this->programID = newProgramID;
+        // Locations may differ in the new program, so resolve them (and our handles) again
+        this->CacheUniformLocations();
+        std::cout << "INFO::SHADER[" << this->programID << "](" << this->vertexFile << " + " << this->fragmentFile << ")::RELOADED" << std::endl;
     }
 
-    // If the compilation succeeded, return true
-    return success > 0;
+    // Files saved while that build was compiling: start the next one right away, since
+    // the watcher's change counter has already been consumed by the caller
+    SubmitIfChanged(watcher, compiler);
 }
 
-bool Shader::LinkProgram(unsigned int programID, char(&infoLog)[512]) {
-    // Assumes that all shaders are attached prior to linking
-    glLinkProgram(programID);
-
-    // Get the link status from the program
-    int success;
-    glGetProgramiv(programID, GL_LINK_STATUS, &success);
-    if (!success) {
-
-        // If it didn't succeed in linking, get the error msg and put in infoLog
-        glGetProgramInfoLog(programID, 512, NULL, infoLog);
-    }
-
-    // Return true if success
-    return success > 0;
+void Shader::SubmitIfChanged(const FileWatcher& watcher, ShaderCompiler& compiler) {
+    // Versions only grow, so any change to either file makes the sum differ
+    uint64_t currentVersion = watcher.Version(this->vertexFile) + watcher.Version(this->fragmentFile);
+    if (currentVersion == fileVersionOnLoad) return;
+    pendingBuild = compiler.Submit(this->vertexFile, this->fragmentFile);
+    pendingVersion = currentVersion;
 }
 
 Shader Shader::LoadShader(std::string fileVertexShader, std::string fileFragmentShader) {
-    // Bool for checking if at any point during loading it failed 
-    bool anyError = false;
-
-    // Reads the code from the shader files
-    std::string vertexCode;
-    if (!ReadFile(fileVertexShader, vertexCode, true)) {
-        std::cout << "ERROR::SHADER::VERTEX(" << fileVertexShader << ")::FILE_NOT_FOUND" << std::endl;
-        anyError = true;
-    }
-    std::string fragmentCode;
-    if (!ReadFile(fileFragmentShader, fragmentCode, true)) {
-        std::cout << "ERROR::SHADER::FRAGMENT(" << fileVertexShader << ")::FILE_NOT_FOUND" << std::endl;
-        anyError = true;
-    }
-
-    if (anyError) {
+    // Same steps the background compiler uses, just waited for right away
+    PendingProgram pending;
+    if (!ShaderCompiler::BeginProgram(fileVertexShader, fileFragmentShader, pending)) {
         return Shader{};
     }
-
-    // Turns them into c-strings
-    const char* vertexCodeCstr = vertexCode.c_str();
-    const char* fragmentCodeCstr = fragmentCode.c_str();
-
-    // Create vertex and fragment shader
-    unsigned int vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
-    unsigned int fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
-
-    // Attach the shader code to its shader
-    glShaderSource(vertexShaderId, 1, &vertexCodeCstr, NULL);
-    glShaderSource(fragmentShaderId, 1, &fragmentCodeCstr, NULL);
-
-    // Attempt to compile the vertex shader
-    char infoLog[512];
-    if (!Shader::CompileShader(vertexShaderId, infoLog)) {
-        std::cout << "ERROR::SHADER::VERTEX(" << fileVertexShader << ")::COMPILATION_FAILED\n" << infoLog << std::endl;
-        anyError = true;
-    }
-    // Attempt to compile the fragment shader
-    if (!Shader::CompileShader(fragmentShaderId, infoLog)) {
-        std::cout << "ERROR::SHADER::FRAGMENT(" << fileFragmentShader << ")::COMPILATION_FAILED\n" << infoLog << std::endl;
-        anyError = true;
-    }
-
-    // Create a shader program
-    unsigned int programID = glCreateProgram();
-
-    // Attach both the vertex and fragment shader to the program
-    glAttachShader(programID, vertexShaderId);
-    glAttachShader(programID, fragmentShaderId);
-
-    // Attempt to link the vertex and fragment shaders
-    if (!Shader::LinkProgram(programID, infoLog)) {
-        std::cout << "ERROR::SHADER::LINKING(" << fileVertexShader << " + " << fileFragmentShader << ")::LINKING_FAILED\n" << infoLog << std::endl;
-        anyError = true;
-    }
-
-    // After linking, we no longer need the individual shaders
-    glDeleteShader(vertexShaderId);
-    glDeleteShader(fragmentShaderId);
+    bool success = ShaderCompiler::FinishProgram(pending);
 
     // Create a shader instance and fill with newly created values
     Shader s;
-    s.fragmentModTimeOnLoad = GetFileModTime(fileFragmentShader);
-    s.programID = programID;
+    s.programID = pending.programID;
     s.vertexFile = fileVertexShader;
     s.fragmentFile = fileFragmentShader;
+    s.CacheUniformLocations();
 
     // If we at any point did NOT get an error, then we say that it loaded successfully
-    if (!anyError) {
+    if (success) {
         std::cout << "INFO::SHADER[" << s.programID << "](" << fileVertexShader << " + " << fileFragmentShader << ")::SUCCESSFULLY_LOADED" << std::endl;
     }
 
     return s;
 }
 
+void Shader::CacheUniformLocations() {
+    uniformLocations.clear();
+
+    int uniformCount = 0;
+    glGetProgramiv(this->programID, GL_ACTIVE_UNIFORMS, &uniformCount);
+    for (int i = 0; i < uniformCount; i++) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(this->programID, (GLuint)i, sizeof(name), &length, &size, &type, name);
+
+        std::string uniformName(name, length);
+        int location = glGetUniformLocation(this->programID, name);
+        uniformLocations[uniformName] = location;
+
+        // Arrays are reported as "name[0]", but are usually set through "name"
+        size_t bracket = uniformName.find("[0]");
+        if (bracket != std::string::npos) {
+            uniformLocations[uniformName.substr(0, bracket)] = location;
+        }
+    }
+
+    for (size_t i = 0; i < handleNames.size(); i++) {
+        handleLocations[i] = GetUniformLocation(handleNames[i]);
+    }
+}
+
+int Shader::GetUniformLocation(const std::string &name) const {
+    auto it = uniformLocations.find(name);
+    // Uniforms optimised away by the compiler are simply ignored, like glGetUniformLocation's -1
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+UniformHandle Shader::GetUniformHandle(const std::string &name) {
+    UniformHandle handle;
+    for (size_t i = 0; i < handleNames.size(); i++) {
+        if (handleNames[i] == name) {
+            handle.index = (int)i;
+            return handle;
+        }
+    }
+
+    handleNames.push_back(name);
+    handleLocations.push_back(GetUniformLocation(name));
+    handle.index = (int)handleNames.size() - 1;
+    return handle;
+}
+
+int Shader::HandleLocation(UniformHandle handle) const {
+    return (handle.index >= 0 && handle.index < (int)handleLocations.size()) ? handleLocations[handle.index] : -1;
+}
+
 void Shader::use() const {
     glUseProgram(this->programID);
 }
 
 void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(this->programID, name.c_str()), (int)value);
+    glUniform1i(GetUniformLocation(name), (int)value);
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(this->programID, name.c_str()), value);
+    glUniform1i(GetUniformLocation(name), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(this->programID, name.c_str()), value);
+    glUniform1f(GetUniformLocation(name), value);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(this->programID, name.c_str()), 1, &value[0]);
+    glUniform3fv(GetUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::setVec3(const std::string &name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(this->programID, name.c_str()), x, y, z);
+    glUniform3f(GetUniformLocation(name), x, y, z);
+}
+
+void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
+    glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(this->programID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setBool(UniformHandle handle, bool value) const {
+    glUniform1i(HandleLocation(handle), (int)value);
+}
+
+void Shader::setInt(UniformHandle handle, int value) const {
+    glUniform1i(HandleLocation(handle), value);
+}
+
+void Shader::setFloat(UniformHandle handle, float value) const {
+    glUniform1f(HandleLocation(handle), value);
+}
+
+void Shader::setVec3(UniformHandle handle, const glm::vec3 &value) const {
+    glUniform3fv(HandleLocation(handle), 1, &value[0]);
+}
+
+void Shader::setVec3(UniformHandle handle, float x, float y, float z) const {
+    glUniform3f(HandleLocation(handle), x, y, z);
+}
+
+void Shader::setMat3(UniformHandle handle, const glm::mat3 &mat) const {
+    glUniformMatrix3fv(HandleLocation(handle), 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat4(UniformHandle handle, const glm::mat4 &mat) const {
+    glUniformMatrix4fv(HandleLocation(handle), 1, GL_FALSE, &mat[0][0]);
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "shaders/shader_compiler.hpp"
+#include "utils/utility.hpp"
+#include "utils/trace.hpp"
+#include <cstring>
+#include <iostream>
+
+// GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile aren't in our glad
+// (3.3 core, no extensions), so the one enum and one entry point are declared here
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP PFN_MaxShaderCompilerThreads)(GLuint count);
+
+ShaderCompiler::ShaderCompiler()
+    : mode(Mode::Synchronous), nextTicket(1), workerWindow(NULL), stopping(false) {
+
+}
+
+ShaderCompiler::~ShaderCompiler() {
+    // GL may already be gone here, so only make sure the worker isn't left running.
+    // Objects are released by Stop, which runs while the context is still current.
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+}
+
+const char* ShaderCompiler::ModeName(Mode mode) {
+    switch (mode) {
+        case Mode::Parallel: return "parallel";
+        case Mode::Worker: return "worker";
+        default: return "synchronous";
+    }
+}
+
+bool ShaderCompiler::HasExtension(const char* name) {
+    int count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (int i = 0; i < count; ++i) {
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension != NULL && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+void ShaderCompiler::Start(GLFWwindow* mainWindow) {
+    const char* extensionNames[] = { "GL_KHR_parallel_shader_compile", "GL_ARB_parallel_shader_compile" };
+    const char* procNames[] = { "glMaxShaderCompilerThreadsKHR", "glMaxShaderCompilerThreadsARB" };
+    for (int i = 0; i < 2; ++i) {
+        if (!HasExtension(extensionNames[i])) continue;
+
+        // 0xFFFFFFFF lets the driver use as many threads as it sees fit
+        PFN_MaxShaderCompilerThreads maxThreads = (PFN_MaxShaderCompilerThreads)glfwGetProcAddress(procNames[i]);
+        if (maxThreads != NULL) maxThreads(0xFFFFFFFFu);
+        mode = Mode::Parallel;
+        std::cout << "INFO::SHADER_COMPILER::MODE " << ModeName(mode) << " (" << extensionNames[i] << ")" << std::endl;
+        return;
+    }
+
+    // No extension: a hidden 1x1 window whose context shares objects with ours.
+    // The current window hints (version, profile, API) still apply, so it matches.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    workerWindow = glfwCreateWindow(1, 1, "shader compiler", NULL, mainWindow);
+    if (workerWindow != NULL) {
+        stopping = false;
+        mode = Mode::Worker;
+        worker = std::thread(&ShaderCompiler::WorkerLoop, this);
+    } else {
+        mode = Mode::Synchronous;
+    }
+    std::cout << "INFO::SHADER_COMPILER::MODE " << ModeName(mode) << std::endl;
+}
+
+void ShaderCompiler::Stop() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+    }
+    if (workerWindow != NULL) {
+        glfwDestroyWindow(workerWindow);
+        workerWindow = NULL;
+    }
+
+    // Builds nobody collected
+    for (auto& entry : inFlight) {
+        FinishProgram(entry.second);
+        glDeleteProgram(entry.second.programID);
+    }
+    inFlight.clear();
+    for (auto& entry : results) glDeleteProgram(entry.second.programID);
+    results.clear();
+    jobs.clear();
+    mode = Mode::Synchronous;
+}
+
+uint64_t ShaderCompiler::Submit(const std::string& vertexFile, const std::string& fragmentFile) {
+    TRACE_SCOPE("ShaderCompiler::Submit");
+    uint64_t ticket = nextTicket++;
+
+    if (mode == Mode::Worker) {
+        Job job;
+        job.ticket = ticket;
+        job.pending.vertexFile = vertexFile;
+        job.pending.fragmentFile = fragmentFile;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(job);
+        }
+        wake.notify_one();
+        return ticket;
+    }
+
+    PendingProgram pending;
+    if (!BeginProgram(vertexFile, fragmentFile, pending)) {
+        results[ticket] = Result{ 0, false };
+    } else if (mode == Mode::Parallel) {
+        inFlight[ticket] = pending;
+    } else {
+        bool success = FinishProgram(pending);
+        results[ticket] = Result{ pending.programID, success };
+    }
+    return ticket;
+}
+
+bool ShaderCompiler::Collect(uint64_t ticket, unsigned int& programID) {
+    auto pending = inFlight.find(ticket);
+    if (pending != inFlight.end()) {
+        if (!ProgramReady(pending->second)) return false;
+        TRACE_SCOPE("ShaderCompiler::Finish");
+        bool success = FinishProgram(pending->second);
+        results[ticket] = Result{ pending->second.programID, success };
+        inFlight.erase(pending);
+    }
+
+    Result result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = results.find(ticket);
+        if (it == results.end()) return false;
+        result = it->second;
+        results.erase(it);
+    }
+
+    if (!result.success && result.programID != 0) {
+        glDeleteProgram(result.programID);
+        result.programID = 0;
+    }
+    programID = result.programID;
+    return true;
+}
+
+void ShaderCompiler::WorkerLoop() {
+    Tracer::SetThreadName("shader compiler");
+    glfwMakeContextCurrent(workerWindow);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (stopping) break;
+
+        Job job = jobs.front();
+        jobs.pop_front();
+        lock.unlock();
+
+        Result result{ 0, false };
+        {
+            TRACE_SCOPE("ShaderCompiler::Build");
+            if (BeginProgram(job.pending.vertexFile, job.pending.fragmentFile, job.pending)) {
+                result.success = FinishProgram(job.pending);
+                result.programID = job.pending.programID;
+            }
+            // The main context may only use the program once our commands completed
+            glFinish();
+        }
+
+        lock.lock();
+        results[job.ticket] = result;
+    }
+    lock.unlock();
+
+    glfwMakeContextCurrent(NULL);
+}
+
+bool ShaderCompiler::BeginProgram(const std::string& vertexFile, const std::string& fragmentFile, PendingProgram& pending) {
+    // Reads the code from the shader files
+    bool anyError = false;
+    std::string vertexCode;
+    if (!ReadFile(vertexFile, vertexCode, true)) {
+        std::cout << "ERROR::SHADER::VERTEX(" << vertexFile << ")::FILE_NOT_FOUND" << std::endl;
+        anyError = true;
+    }
+    std::string fragmentCode;
+    if (!ReadFile(fragmentFile, fragmentCode, true)) {
+        std::cout << "ERROR::SHADER::FRAGMENT(" << fragmentFile << ")::FILE_NOT_FOUND" << std::endl;
+        anyError = true;
+    }
+    if (anyError) return false;
+
+    const char* vertexCodeCstr = vertexCode.c_str();
+    const char* fragmentCodeCstr = fragmentCode.c_str();
+
+    pending.vertexFile = vertexFile;
+    pending.fragmentFile = fragmentFile;
+    pending.vertexShaderID = glCreateShader(GL_VERTEX_SHADER);
+    pending.fragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pending.vertexShaderID, 1, &vertexCodeCstr, NULL);
+    glShaderSource(pending.fragmentShaderID, 1, &fragmentCodeCstr, NULL);
+
+    // With parallel compile these only queue the work; nothing below waits on it
+    glCompileShader(pending.vertexShaderID);
+    glCompileShader(pending.fragmentShaderID);
+
+    pending.programID = glCreateProgram();
+    glAttachShader(pending.programID, pending.vertexShaderID);
+    glAttachShader(pending.programID, pending.fragmentShaderID);
+    glLinkProgram(pending.programID);
+    return true;
+}
+
+bool ShaderCompiler::ProgramReady(const PendingProgram& pending) {
+    // Only valid with the extension (Parallel mode); elsewhere builds are never in flight
+    int complete = 1;
+    glGetProgramiv(pending.programID, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete != 0;
+}
+
+bool ShaderCompiler::FinishProgram(PendingProgram& pending) {
+    bool anyError = false;
+    char infoLog[512];
+    int success = 0;
+
+    glGetShaderiv(pending.vertexShaderID, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(pending.vertexShaderID, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::VERTEX(" << pending.vertexFile << ")::COMPILATION_FAILED\n" << infoLog << std::endl;
+        anyError = true;
+    }
+    glGetShaderiv(pending.fragmentShaderID, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(pending.fragmentShaderID, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::FRAGMENT(" << pending.fragmentFile << ")::COMPILATION_FAILED\n" << infoLog << std::endl;
+        anyError = true;
+    }
+    glGetProgramiv(pending.programID, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(pending.programID, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::LINKING(" << pending.vertexFile << " + " << pending.fragmentFile << ")::LINKING_FAILED\n" << infoLog << std::endl;
+        anyError = true;
+    }
+
+    // After linking, we no longer need the individual shaders
+    glDeleteShader(pending.vertexShaderID);
+    glDeleteShader(pending.fragmentShaderID);
+    pending.vertexShaderID = 0;
+    pending.fragmentShaderID = 0;
+    return !anyError;
+}
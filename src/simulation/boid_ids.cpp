@@ -0,0 +1,67 @@
+#include "simulation/boid_ids.hpp"
+
+void BoidIdTable::Reserve(size_t count) {
+    slotToId.reserve(count);
+    idToSlot.reserve(count);
+}
+
+void BoidIdTable::Clear() {
+    slotToId.clear();
+    idToSlot.clear();
+    freeIds.clear();
+}
+
+uint32_t BoidIdTable::Append() {
+    uint32_t id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = (uint32_t)idToSlot.size();
+        idToSlot.push_back(-1);
+    }
+    idToSlot[id] = (int)slotToId.size();
+    slotToId.push_back(id);
+    return id;
+}
+
+void BoidIdTable::SwapRemove(size_t slot) {
+    uint32_t removed = slotToId[slot];
+    uint32_t moved = slotToId.back();
+    slotToId[slot] = moved;
+    idToSlot[moved] = (int)slot;
+    slotToId.pop_back();
+
+    idToSlot[removed] = -1;
+    freeIds.push_back(removed);
+}
+
+void BoidIdTable::PopBack() {
+    if (slotToId.empty()) return;
+    SwapRemove(slotToId.size() - 1);
+}
+
+long long BoidIdTable::SlotOf(uint32_t id) const {
+    if (id >= idToSlot.size()) return -1;
+    return idToSlot[id];
+}
+
+bool BoidIdTable::Restore(const uint32_t* slotIds, size_t count, const uint32_t* freeIdList, size_t freeCount, uint32_t idLimit) {
+    // Todo ID abaixo do limite está em uso (uma única vez) ou livre, nunca os dois
+    if (count + freeCount != idLimit) return false;
+    std::vector<int> slots(idLimit, -1);
+    for (size_t i = 0; i < count; ++i) {
+        if (slotIds[i] >= idLimit || slots[slotIds[i]] != -1) return false;
+        slots[slotIds[i]] = (int)i;
+    }
+    std::vector<bool> freed(idLimit, false);
+    for (size_t i = 0; i < freeCount; ++i) {
+        if (freeIdList[i] >= idLimit || slots[freeIdList[i]] != -1 || freed[freeIdList[i]]) return false;
+        freed[freeIdList[i]] = true;
+    }
+
+    slotToId.assign(slotIds, slotIds + count);
+    freeIds.assign(freeIdList, freeIdList + freeCount);
+    idToSlot.swap(slots);
+    return true;
+}
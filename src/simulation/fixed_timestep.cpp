@@ -0,0 +1,29 @@
+#include "simulation/fixed_timestep.hpp"
+#include <cmath>
+
+FixedTimestep::FixedTimestep(float hz, int substeps)
+    : stepHz(hz), maxSubsteps(substeps), droppedSteps(0), accumulator(0.0) {
+
+}
+
+int FixedTimestep::Advance(double frameSeconds) {
+    if (frameSeconds < 0.0) frameSeconds = 0.0;
+    double step = 1.0 / stepHz;
+    accumulator += frameSeconds;
+
+    int steps = (int)std::floor(accumulator / step);
+    if (steps > maxSubsteps) {
+        // Frame lento demais: simular tudo deixaria o próximo frame ainda mais lento.
+        // Descarta o atraso e guarda só a fração do passo corrente.
+        droppedSteps += steps - maxSubsteps;
+        steps = maxSubsteps;
+        accumulator = std::fmod(accumulator, step) + steps * step;
+    }
+    accumulator -= steps * step;
+    return steps;
+}
+
+float FixedTimestep::Alpha() const {
+    float alpha = (float)(accumulator * stepHz);
+    return alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+}
@@ -0,0 +1,14 @@
+#include "simulation/flock_double_buffer.hpp"
+
+FlockDoubleBuffer::FlockDoubleBuffer() : readIndex(0) {
+
+}
+
+void FlockDoubleBuffer::BeginStep() {
+    // Boids podem ter sido adicionados/removidos no estado atual desde o último passo
+    Write().Resize(Read().Size());
+}
+
+void FlockDoubleBuffer::Swap() {
+    readIndex = 1 - readIndex;
+}
@@ -0,0 +1,494 @@
+#include "simulation/flock_simulation.hpp"
+#include "simulation/input_log.hpp"
+#include "simulation/trajectory_recorder.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// Boids por tarefa do pool de threads
+const size_t FLOCK_CHUNK_SIZE = 256;
+// Boids por bloco de spawn; cada bloco tem seu próprio stream do gerador
+const size_t SPAWN_CHUNK_SIZE = 4096;
+// Capacidade inicial do pool de boids
+const size_t DEFAULT_POOL_CAPACITY = 4096;
+
+Boid::Boid(glm::vec3 startPos, Random& rng) {
+    position = startPos;
+    float vx = (float)rng.NextInt(10) - 5.0f;
+    float vz = (float)rng.NextInt(10) - 5.0f;
+    velocity = glm::vec3(vx, 0.0f, vz);
+    if(glm::length(velocity) < 0.1f) velocity = glm::vec3(0,0,1);
+    velocity = glm::normalize(velocity) * MIN_SPEED;
+
+    forwardDirection = glm::normalize(velocity);
+    wingAngle = (float)rng.NextInt(100);
+    wingSpeed = 15.0f + (float)rng.NextInt(10);
+    acceleration = glm::vec3(0.0f);
+}
+
+Boid::Boid()
+    : position(0.0f),
+      velocity(0.0f, 0.0f, MIN_SPEED),
+      acceleration(0.0f),
+      forwardDirection(0.0f, 0.0f, 1.0f),
+      wingAngle(0.0f),
+      wingSpeed(15.0f) {
+
+}
+
+FlockSimulation::FlockSimulation()
+    : rng(1),
+      seed(1),
+      leader(glm::vec3(0.0f, 15.0f, 0.0f), rng),
+      leaderInputDirection(0.0f),
+      flockCenter(0.0f),
+      flockAverageVelocity(0.0f, 0.0f, 1.0f),
+      smoothFlockCenter(0.0f, 15.0f, 0.0f),
+      smoothFlockVelocity(0.0f, 0.0f, 1.0f),
+      previousLeader(leader),
+      previousSmoothFlockCenter(smoothFlockCenter),
+      previousSmoothFlockVelocity(smoothFlockVelocity),
+      useSpatialGrid(true),
+      threadCount((int)ThreadPool::HardwareThreads()),
+      steeringKernel(BestSteeringKernel()),
+      recorder(nullptr),
+      inputLog(nullptr),
+      gatherKernel(GatherNeighborsScalar) {
+    Reserve(DEFAULT_POOL_CAPACITY);
+}
+
+void FlockSimulation::Seed(uint64_t newSeed) {
+    seed = newSeed;
+    rng.Seed(newSeed);
+}
+
+void FlockSimulation::ResetInterpolation() {
+    previousLeader = leader;
+    previousSmoothFlockCenter = smoothFlockCenter;
+    previousSmoothFlockVelocity = smoothFlockVelocity;
+}
+
+void FlockSimulation::AddBoid(const Boid& b) {
+    EnsureCapacity(Flock().Size() + 1);
+    Flock().Add(b.position, b.velocity, b.forwardDirection, b.wingAngle, b.wingSpeed);
+    ids.Append();
+}
+
+bool FlockSimulation::RemoveBoid() {
+    if (Flock().Empty()) return false;
+    RemoveSlot(Flock().Size() - 1);
+    return true;
+}
+
+// --- POOL DE BOIDS ---
+void FlockSimulation::Reserve(size_t capacity) {
+    state.Read().Reserve(capacity);
+    state.Write().Reserve(capacity);
+    ids.Reserve(capacity);
+    neighborSums.reserve(capacity);
+}
+
+void FlockSimulation::EnsureCapacity(size_t count) {
+    if (count > Capacity()) Reserve(std::max(count, Capacity() * 2));
+}
+
+void FlockSimulation::Clear() {
+    state.Read().Clear();
+    state.Write().Clear();
+    ids.Clear();
+}
+
+void FlockSimulation::RemoveSlot(size_t slot) {
+    FlockSoA& flock = state.Read();
+    // O estado anterior (interpolação do render) recebe a mesma troca enquanto estiver
+    // alinhado com o atual, senão o boid movido interpolaria a partir do removido
+    FlockSoA& previous = state.Write();
+    bool aligned = previous.Size() == flock.Size();
+    if (aligned) previous.SwapRemove(slot);
+    flock.SwapRemove(slot);
+    ids.SwapRemove(slot);
+
+    // Desalinhado (houve spawn desde o último passo), o boid movido é um dos recém-criados:
+    // se o slot dele ainda existe no anterior, copia o estado atual para que seja desenhado
+    // parado onde está, como os outros recém-criados, e não a partir do removido
+    if (!aligned && slot < previous.Size() && slot < flock.Size()) {
+        previous.SetPosition(slot, flock.Position(slot));
+        previous.SetVelocity(slot, flock.Velocity(slot));
+        previous.SetForward(slot, flock.Forward(slot));
+        previous.wingAngle[slot] = flock.wingAngle[slot];
+        previous.wingSpeed[slot] = flock.wingSpeed[slot];
+    }
+}
+
+size_t FlockSimulation::Spawn(const SpawnParams& params) {
+    FlockSoA& flock = Flock();
+    size_t first = flock.Size();
+    if (params.count == 0) return first;
+
+    EnsureCapacity(first + params.count);
+    flock.Resize(first + params.count);
+    for (size_t i = 0; i < params.count; ++i) ids.Append();
+
+    float radius = params.radius > 0.0f ? params.radius : AutoSpawnRadius(params.shape, params.count);
+    // Uma semente por chamada; os blocos têm limites fixos, então o stream de cada
+    // boid não depende de como o pool dividiu o trabalho
+    uint64_t spawnSeed = rng.Next();
+
+    pool.Resize((size_t)threadCount);
+    pool.ParallelFor(params.count, SPAWN_CHUNK_SIZE, [&](size_t begin, size_t end) {
+        Random chunkRng(spawnSeed, begin / SPAWN_CHUNK_SIZE);
+        for (size_t i = begin; i < end; ++i) {
+            Boid b(params.center + SampleSpawnOffset(params.shape, radius, chunkRng), chunkRng);
+            size_t slot = first + i;
+            flock.SetPosition(slot, b.position);
+            flock.SetVelocity(slot, b.velocity);
+            flock.SetForward(slot, b.forwardDirection);
+            flock.wingAngle[slot] = b.wingAngle;
+            flock.wingSpeed[slot] = b.wingSpeed;
+        }
+    });
+    return first;
+}
+
+size_t FlockSimulation::Despawn(size_t count) {
+    count = std::min(count, Flock().Size());
+    for (size_t i = 0; i < count; ++i) {
+        RemoveSlot(rng.NextInt((uint32_t)Flock().Size()));
+    }
+    return count;
+}
+
+bool FlockSimulation::DespawnId(uint32_t id) {
+    long long slot = ids.SlotOf(id);
+    if (slot < 0) return false;
+    RemoveSlot((size_t)slot);
+    return true;
+}
+
+void FlockSimulation::SetTargetCount(size_t count, SpawnShape shape) {
+    size_t current = Flock().Size();
+    if (count > current) {
+        SpawnParams params;
+        params.shape = shape;
+        params.center = leader.position;
+        params.count = count - current;
+        Spawn(params);
+    } else {
+        Despawn(current - count);
+    }
+}
+
+bool FlockSimulation::Apply(const SimCommand& command) {
+    if (inputLog != nullptr) inputLog->Record(command);
+    switch (command.type) {
+        case SimCommand::SetLeaderDirection:
+            leaderInputDirection = command.vector;
+            return true;
+        case SimCommand::AddBoid: {
+            // Perto do líder; deslocamento e boid sorteados do gerador da simulação
+            float ox = (float)rng.NextInt(5);
+            float oy = (float)rng.NextInt(5);
+            float oz = (float)rng.NextInt(5);
+            AddBoid(Boid(leader.position + glm::vec3(ox, oy, oz), rng));
+            return true;
+        }
+        case SimCommand::RemoveBoid:
+            RemoveBoid();
+            return true;
+        case SimCommand::SpawnBoids: {
+            SpawnParams params;
+            params.shape = command.shape;
+            params.center = leader.position + command.vector;
+            params.count = (size_t)command.value;
+            Spawn(params);
+            return true;
+        }
+        case SimCommand::DespawnBoids:
+            Despawn((size_t)command.value);
+            return true;
+        case SimCommand::SetTargetCount:
+            SetTargetCount((size_t)command.value, command.shape);
+            return true;
+        case SimCommand::SetSpatialGrid:
+            useSpatialGrid = command.value != 0.0f;
+            return true;
+        case SimCommand::SetThreadCount:
+            // O pool trata o valor como size_t: zero ou negativo vira uma thread só
+            threadCount = command.value >= 1.0f ? (int)command.value : 1;
+            return true;
+        case SimCommand::SetSteeringKernel:
+            steeringKernel = (SteeringKernel)(int)command.value;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// --- LÓGICA DE FLOCKING ---
+static glm::vec3 limitVector(glm::vec3 v, float maxVal) {
+    if (glm::length(v) > maxVal) return glm::normalize(v) * maxVal;
+    return v;
+}
+
+static glm::vec3 SteerTowards(glm::vec3 position, glm::vec3 velocity, glm::vec3 target) {
+    glm::vec3 desired = target - position;
+    float dist = glm::length(desired);
+    if (dist == 0) return glm::vec3(0.0f);
+
+    desired = glm::normalize(desired) * MAX_SPEED;
+
+    glm::vec3 steer = desired - velocity;
+    if (glm::length(steer) > MAX_FORCE) {
+        steer = glm::normalize(steer) * MAX_FORCE;
+    }
+    return steer;
+}
+
+void FlockSimulation::StepLeader(float dt) {
+    // --- FÍSICA DO LÍDER (MOVIMENTO SUAVE E RÁPIDO) ---
+    if (glm::length(leaderInputDirection) > 0.0f) {
+        leader.acceleration = glm::normalize(leaderInputDirection) * LEADER_THRUST;
+    } else {
+        leader.acceleration = glm::vec3(0.0f);
+    }
+
+    leader.velocity += leader.acceleration * dt * 5.0f; // Multiplicador de agilidade
+
+    leader.velocity *= LEADER_DAMPING;
+
+    if (glm::length(leader.velocity) > LEADER_MAX_SPEED) {
+        leader.velocity = glm::normalize(leader.velocity) * LEADER_MAX_SPEED;
+    }
+
+    leader.position += leader.velocity * dt;
+    if (glm::length(leader.velocity) > 0.1f)
+        leader.forwardDirection = glm::normalize(leader.velocity);
+    leader.wingAngle += leader.wingSpeed * dt;
+    // --- FIM DA FÍSICA DO LÍDER ---
+}
+
+void FlockSimulation::GatherNeighbors(size_t bi, const FlockSoA& prev, std::vector<int>& candidates, NeighborSums& sums) const {
+    // --- 1. SOMAS DOS VIZINHOS ---
+    if (useSpatialGrid) {
+        // Candidatos vêm em ordem crescente, mesma ordem de soma do força-bruta
+        grid.Query(prev.Position(bi), candidates);
+    } else if (candidates.size() != prev.Size()) {
+        // Força-bruta: todos os boids são candidatos (lista reaproveitada entre boids)
+        candidates.resize(prev.Size());
+        for (size_t i = 0; i < candidates.size(); ++i) candidates[i] = (int)i;
+    }
+    gatherKernel(prev, bi, candidates.data(), candidates.size(), sums);
+}
+
+void FlockSimulation::IntegrateBoid(size_t bi, const FlockSoA& prev, FlockSoA& next, float dt, const NeighborSums& sums) const {
+    glm::vec3 position = prev.Position(bi);
+    glm::vec3 velocity = prev.Velocity(bi);
+
+    glm::vec3 acceleration = FlockingForce(position, velocity, sums);
+    AddObstacleForces(position, velocity, acceleration);
+    IntegrateMotion(bi, prev, next, dt, acceleration);
+}
+
+glm::vec3 FlockSimulation::FlockingForce(const glm::vec3& position, const glm::vec3& velocity, const NeighborSums& sums) const {
+    glm::vec3 cohesion = sums.cohesion;
+    glm::vec3 alignment = sums.alignment;
+    glm::vec3 separation = sums.separation;
+    int neighbors = sums.count;
+
+    // --- 2. FORÇAS DE BANDO E LÍDER ---
+    glm::vec3 steerAli(0.0f), steerCoh(0.0f), steerSep(0.0f);
+    if (neighbors > 0) {
+        cohesion /= (float)neighbors;
+        steerCoh = SteerTowards(position, velocity, cohesion);
+        alignment /= (float)neighbors;
+        alignment = glm::normalize(alignment) * MAX_SPEED;
+        steerAli = alignment - velocity;
+        steerAli = limitVector(steerAli, MAX_FORCE);
+        if(glm::length(separation) > 0) {
+            separation = glm::normalize(separation) * MAX_SPEED;
+            steerSep = separation - velocity;
+            steerSep = limitVector(steerSep, MAX_FORCE);
+        }
+    }
+
+    glm::vec3 steerGoal = SteerTowards(position, velocity, leader.position);
+
+    // --- 4. SOMA PONDERADA (bando e líder; os obstáculos entram em seguida) ---
+    glm::vec3 acceleration(0.0f);
+    acceleration += steerSep * WEIGHT_SEPARATION;
+    acceleration += steerAli * WEIGHT_ALIGNMENT;
+    acceleration += steerCoh * WEIGHT_COHESION;
+    acceleration += steerGoal * WEIGHT_GOAL;
+    return acceleration;
+}
+
+void FlockSimulation::AddObstacleForces(const glm::vec3& position, const glm::vec3& velocity, glm::vec3& acceleration) const {
+    // --- 3. CÁLCULO DAS FORÇAS DE OBSTÁCULO ---
+    glm::vec3 steerFloor(0.0f);
+    if (position.y < GROUND_AVOID_HEIGHT) { 
+        glm::vec3 desired = velocity;
+        desired.y = MAX_SPEED;
+        steerFloor = desired - velocity;
+    }
+
+    // --- Cálculo da Força de Obstáculo (Contorno) ---
+    glm::vec3 steerObstacle(0.0f);
+    float distToTowerCenter = glm::length(glm::vec2(position.x, position.z));
+
+    if (distToTowerCenter < OBSTACLE_AVOID_RADIUS && position.y < TOWER_HEIGHT)
+    {
+
+        glm::vec3 pushDirection = glm::normalize(glm::vec3(position.x, 0.0f, position.z));
+        float penetration = (OBSTACLE_AVOID_RADIUS - distToTowerCenter);
+        float strength = glm::clamp(penetration / (OBSTACLE_AVOID_RADIUS - TOWER_RADIUS), 0.0f, 1.0f); // Normaliza (0-1)
+        steerObstacle = (pushDirection + glm::vec3(0.0f, 0.3f, 0.0f)) * MAX_SPEED * strength;
+    }
+    // ----------------------------------------------------
+
+    acceleration += steerFloor * WEIGHT_AVOID_FLOOR;
+    acceleration += steerObstacle * WEIGHT_AVOID_OBSTACLE; 
+}
+
+void FlockSimulation::IntegrateMotion(size_t bi, const FlockSoA& prev, FlockSoA& next, float dt, glm::vec3 acceleration) const {
+    glm::vec3 position = prev.Position(bi);
+    glm::vec3 velocity = prev.Velocity(bi);
+
+    // --- 5. APLICA FÍSICA ---
+    acceleration = limitVector(acceleration, MAX_FORCE * 2.0f); 
+    velocity += acceleration * dt * 5.0f;
+    velocity = limitVector(velocity, MAX_SPEED);
+
+    if (glm::length(velocity) < MIN_SPEED)
+         velocity = glm::normalize(velocity) * MIN_SPEED;
+
+    position += velocity * dt;
+    next.wingAngle[bi] = prev.wingAngle[bi] + prev.wingSpeed[bi] * dt;
+    next.wingSpeed[bi] = prev.wingSpeed[bi];
+    next.SetForward(bi, glm::normalize(velocity));
+
+    float distToTower = glm::length(glm::vec2(position.x, position.z));
+    if (distToTower < (TOWER_RADIUS - 0.2f)) {
+
+        glm::vec3 pushOut = glm::normalize(glm::vec3(position.x, 0.0f, position.z));
+        position.x = pushOut.x * (TOWER_RADIUS + 0.5f);
+        position.z = pushOut.z * (TOWER_RADIUS + 0.5f);
+        velocity = glm::normalize(glm::vec3(pushOut.x, 0.2f, pushOut.z)) * (MIN_SPEED + 1.0f);
+    }
+
+    next.SetPosition(bi, position);
+    next.SetVelocity(bi, velocity);
+}
+
+void FlockSimulation::Step(float dt, bool debugPrint) {
+    TRACE_SCOPE("UpdateFlock");
+    if (inputLog != nullptr) inputLog->RecordStep(dt);
+    Stopwatch stepTimer;
+    previousLeader = leader;
+    previousSmoothFlockCenter = smoothFlockCenter;
+    previousSmoothFlockVelocity = smoothFlockVelocity;
+
+    StepLeader(dt);
+    lastStepTimings.leader = stepTimer.Milliseconds();
+
+    // --- FÍSICA DO BANDO ---
+    glm::vec3 centerSum(0.0f);
+    glm::vec3 velocitySum(0.0f);
+
+    // Todos os boids leem vizinhos do estado atual e escrevem no buffer de escrita
+    state.BeginStep();
+    const FlockSoA& prev = state.Read();
+    FlockSoA& next = state.Write();
+
+    // Fase 1: busca de vizinhos (grade + somas); fase 2: forças e integração.
+    // Separadas para o profiler medir cada uma.
+    Stopwatch phaseTimer;
+    if (useSpatialGrid) {
+        TRACE_SCOPE("SpatialGrid::Build");
+        grid.Build(PERCEPTION_RADIUS, prev.px, prev.py, prev.pz);
+    }
+
+    pool.Resize((size_t)threadCount);
+    gatherKernel = SelectSteeringKernel(steeringKernel);
+    neighborSums.resize(prev.Size());
+    pool.ParallelFor(prev.Size(), FLOCK_CHUNK_SIZE, [this, &prev](size_t begin, size_t end) {
+        TRACE_SCOPE("GatherNeighbors");
+        thread_local std::vector<int> candidates;
+        for (size_t bi = begin; bi < end; ++bi)
+            GatherNeighbors(bi, prev, candidates, neighborSums[bi]);
+    });
+    lastStepTimings.neighborSearch = phaseTimer.Milliseconds();
+
+    phaseTimer.Restart();
+    pool.ParallelFor(prev.Size(), FLOCK_CHUNK_SIZE, [this, dt, &prev, &next](size_t begin, size_t end) {
+        TRACE_SCOPE("IntegrateBoids");
+        for (size_t bi = begin; bi < end; ++bi)
+            IntegrateBoid(bi, prev, next, dt, neighborSums[bi]);
+    });
+    state.Swap();
+    const FlockSoA& flock = state.Read();
+
+    // Soma em ordem fixa, independente do número de threads
+    for (size_t bi = 0; bi < flock.Size(); ++bi) {
+        centerSum += flock.Position(bi);
+        velocitySum += flock.Velocity(bi);
+    }
+
+    // --- Cálculo Final da Média do Bando (Alvo da Câmera) ---
+    if (!flock.Empty()) {
+        flockCenter = centerSum / (float)flock.Size();
+        flockAverageVelocity = velocitySum / (float)flock.Size();
+    } else {
+        flockCenter = leader.position;
+        flockAverageVelocity = leader.velocity;
+    }
+
+    // --- Lógica de Câmera Suave ---
+    float smoothFactor = 1.0f - exp(-dt * CAMERA_SMOOTH_SPEED);
+    smoothFlockCenter = glm::mix(smoothFlockCenter, flockCenter, smoothFactor);
+
+    if (glm::length(flockAverageVelocity) > 0.1f) {
+        smoothFlockVelocity = glm::mix(smoothFlockVelocity, glm::normalize(flockAverageVelocity), smoothFactor);
+    }
+    lastStepTimings.integration = phaseTimer.Milliseconds();
+    lastStepTimings.total = stepTimer.Milliseconds();
+
+    if (recorder != nullptr) recorder->Capture(*this);
+
+    // --- DEBUG PRINT (opcional) ---
+    if (debugPrint) {
+        std::cout << "DEBUG: flock size = " << flock.Size() << ", leader pos = ("
+                  << leader.position.x << ", " << leader.position.y << ", " << leader.position.z << ")\n";
+        size_t limit = std::min((size_t)5, flock.Size());
+        for (size_t i = 0; i < limit; ++i) {
+            std::cout << "  Boid[" << i << "] pos=("
+                      << flock.px[i] << "," << flock.py[i] << "," << flock.pz[i]
+                      << ") vel=(" << flock.vx[i] << "," << flock.vy[i] << "," << flock.vz[i] << ")\n";
+        }
+    }
+}
+
+unsigned long long FlockSimulation::Checksum() const {
+    // FNV-1a sobre os bits dos floats: qualquer diferença de arredondamento muda o hash
+    unsigned long long hash = 14695981039346656037ull;
+    auto mix = [&hash](float value) {
+        unsigned int bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (bits >> (i * 8)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    const FlockSoA& flock = Flock();
+    const std::vector<float>* arrays[] = { &flock.px, &flock.py, &flock.pz, &flock.vx, &flock.vy, &flock.vz };
+    for (const std::vector<float>* values : arrays) {
+        for (float v : *values) mix(v);
+    }
+    for (int c = 0; c < 3; ++c) {
+        mix(leader.position[c]);
+        mix(leader.velocity[c]);
+    }
+    return hash;
+}
@@ -0,0 +1,216 @@
+#include "simulation/flock_simulation.hpp"
+#include "simulation/flock_snapshot_file.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+SnapshotVec3 ToSnapshot(const glm::vec3& v) {
+    SnapshotVec3 out = { v.x, v.y, v.z };
+    return out;
+}
+
+glm::vec3 FromSnapshot(const SnapshotVec3& v) {
+    return glm::vec3(v.x, v.y, v.z);
+}
+
+SnapshotBoid ToSnapshot(const Boid& b) {
+    SnapshotBoid out;
+    out.position = ToSnapshot(b.position);
+    out.velocity = ToSnapshot(b.velocity);
+    out.acceleration = ToSnapshot(b.acceleration);
+    out.forwardDirection = ToSnapshot(b.forwardDirection);
+    out.wingAngle = b.wingAngle;
+    out.wingSpeed = b.wingSpeed;
+    return out;
+}
+
+Boid FromSnapshot(const SnapshotBoid& b) {
+    Boid out;
+    out.position = FromSnapshot(b.position);
+    out.velocity = FromSnapshot(b.velocity);
+    out.acceleration = FromSnapshot(b.acceleration);
+    out.forwardDirection = FromSnapshot(b.forwardDirection);
+    out.wingAngle = b.wingAngle;
+    out.wingSpeed = b.wingSpeed;
+    return out;
+}
+
+size_t AlignSection(size_t bytes) {
+    return (bytes + SNAPSHOT_SECTION_ALIGNMENT - 1) / SNAPSHOT_SECTION_ALIGNMENT * SNAPSHOT_SECTION_ALIGNMENT;
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+void FlockSimulation::SaveSnapshot(std::vector<unsigned char>& buffer) const {
+    const FlockSoA& flock = Flock();
+    const std::vector<uint32_t>& slotIds = ids.SlotIds();
+    const std::vector<uint32_t>& freeIds = ids.FreeIds();
+
+    // Todas as seções têm elementos de 4 bytes (float ou uint32)
+    const void* sections[SNAPSHOT_SECTION_COUNT] = {
+        flock.px.data(), flock.py.data(), flock.pz.data(),
+        flock.vx.data(), flock.vy.data(), flock.vz.data(),
+        flock.fx.data(), flock.fy.data(), flock.fz.data(),
+        flock.wingAngle.data(), flock.wingSpeed.data(),
+        slotIds.data(), freeIds.data()
+    };
+
+    SnapshotFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_FILE_VERSION;
+    header.headerBytes = (uint32_t)sizeof(SnapshotFileHeader);
+    header.endianTag = SNAPSHOT_ENDIAN_TAG;
+    header.idLimit = ids.IdLimit();
+    header.boidCount = flock.Size();
+    header.freeIdCount = freeIds.size();
+    header.seed = seed;
+    std::memcpy(header.rngState, rng.state, sizeof(header.rngState));
+    header.leader = ToSnapshot(leader);
+    header.previousLeader = ToSnapshot(previousLeader);
+    header.leaderInputDirection = ToSnapshot(leaderInputDirection);
+    header.flockCenter = ToSnapshot(flockCenter);
+    header.flockAverageVelocity = ToSnapshot(flockAverageVelocity);
+    header.smoothFlockCenter = ToSnapshot(smoothFlockCenter);
+    header.smoothFlockVelocity = ToSnapshot(smoothFlockVelocity);
+    header.previousSmoothFlockCenter = ToSnapshot(previousSmoothFlockCenter);
+    header.previousSmoothFlockVelocity = ToSnapshot(previousSmoothFlockVelocity);
+
+    size_t sectionBytes[SNAPSHOT_SECTION_COUNT];
+    size_t offset = AlignSection(sizeof(SnapshotFileHeader));
+    for (int s = 0; s < SNAPSHOT_SECTION_COUNT; ++s) {
+        sectionBytes[s] = (s == SNAPSHOT_FREE_IDS ? freeIds.size() : flock.Size()) * sizeof(float);
+        header.sectionOffset[s] = offset;
+        offset = AlignSection(offset + sectionBytes[s]);
+    }
+    header.fileBytes = offset;
+
+    // O arquivo é montado inteiro na memória (preenchimento zerado)
+    buffer.assign(offset, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    for (int s = 0; s < SNAPSHOT_SECTION_COUNT; ++s) {
+        if (sectionBytes[s] > 0) std::memcpy(buffer.data() + header.sectionOffset[s], sections[s], sectionBytes[s]);
+    }
+}
+
+bool FlockSimulation::SaveSnapshotFile(const std::string& path) const {
+    TRACE_SCOPE("FlockSimulation::SaveSnapshotFile");
+    auto start = std::chrono::steady_clock::now();
+    // Montado na memória e gravado numa escrita só
+    std::vector<unsigned char> buffer;
+    SaveSnapshot(buffer);
+
+    // Grava num temporário e renomeia: um snapshot interrompido nunca substitui o anterior
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::SNAPSHOT::" << tempPath << "::CANNOT_OPEN" << std::endl;
+        return false;
+    }
+    bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    written = (fclose(file) == 0) && written;
+#ifdef _WIN32
+    // rename() do Windows não substitui um arquivo existente
+    if (written) std::remove(path.c_str());
+#endif
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cout << "ERROR::SNAPSHOT::" << path << "::WRITE_FAILED" << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    printf("INFO::SNAPSHOT::SAVED %zu boids (%.1f MiB) to %s in %.1f ms\n",
+           Flock().Size(), buffer.size() / (1024.0 * 1024.0), path.c_str(), MillisecondsSince(start));
+    return true;
+}
+
+bool FlockSimulation::LoadSnapshotFile(const std::string& path) {
+    TRACE_SCOPE("FlockSimulation::LoadSnapshotFile");
+    auto start = std::chrono::steady_clock::now();
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    if (!LoadSnapshot(file.Data(), file.Size(), path)) return false;
+
+    printf("INFO::SNAPSHOT::LOADED %zu boids (%.1f MiB) from %s in %.1f ms\n",
+           Flock().Size(), file.Size() / (1024.0 * 1024.0), path.c_str(), MillisecondsSince(start));
+    return true;
+}
+
+bool FlockSimulation::LoadSnapshot(const unsigned char* data, size_t size, const std::string& source) {
+    auto reject = [&source](const char* reason) {
+        std::cout << "ERROR::SNAPSHOT::" << source << "::" << reason << std::endl;
+        return false;
+    };
+    if (size < sizeof(SnapshotFileHeader)) return reject("TRUNCATED");
+
+    // Um mapeamento começa numa página (e snapshots embutidos em outros arquivos ficam
+    // alinhados a SNAPSHOT_SECTION_ALIGNMENT), então o cabeçalho pode ser lido no lugar
+    const SnapshotFileHeader& header = *reinterpret_cast<const SnapshotFileHeader*>(data);
+    if (std::memcmp(header.magic, SNAPSHOT_FILE_MAGIC, sizeof(header.magic)) != 0) return reject("NOT_A_SNAPSHOT");
+    if (header.endianTag != SNAPSHOT_ENDIAN_TAG) return reject("WRONG_BYTE_ORDER");
+    if (header.version != SNAPSHOT_FILE_VERSION || header.headerBytes != sizeof(SnapshotFileHeader)) {
+        return reject("UNSUPPORTED_VERSION");
+    }
+    if (header.fileBytes != size) return reject("TRUNCATED");
+
+    // Cada seção precisa caber no arquivo e estar alinhada para ser lida como float/uint32
+    for (int s = 0; s < SNAPSHOT_SECTION_COUNT; ++s) {
+        uint64_t count = s == SNAPSHOT_FREE_IDS ? header.freeIdCount : header.boidCount;
+        uint64_t offset = header.sectionOffset[s];
+        if (offset % sizeof(float) != 0 || offset > size || count > (size - offset) / sizeof(float)) {
+            return reject("BAD_SECTION");
+        }
+    }
+    auto section = [data, &header](int s) {
+        return reinterpret_cast<const float*>(data + header.sectionOffset[s]);
+    };
+    auto idSection = [data, &header](int s) {
+        return reinterpret_cast<const uint32_t*>(data + header.sectionOffset[s]);
+    };
+
+    // A tabela de IDs é a única parte que pode ser inconsistente; valida antes de mexer no estado
+    size_t count = (size_t)header.boidCount;
+    BoidIdTable restoredIds;
+    if (!restoredIds.Restore(idSection(SNAPSHOT_SLOT_IDS), count, idSection(SNAPSHOT_FREE_IDS),
+                             (size_t)header.freeIdCount, header.idLimit)) {
+        return reject("BAD_IDS");
+    }
+
+    FlockSoA& flock = state.Read();
+    std::vector<float>* arrays[] = {
+        &flock.px, &flock.py, &flock.pz,
+        &flock.vx, &flock.vy, &flock.vz,
+        &flock.fx, &flock.fy, &flock.fz,
+        &flock.wingAngle, &flock.wingSpeed
+    };
+    for (int s = 0; s <= SNAPSHOT_WING_SPEED; ++s) {
+        const float* values = section(s);
+        arrays[s]->assign(values, values + count);
+    }
+    // Sem um passo anterior salvo, o render interpola a partir do próprio estado carregado
+    state.Write() = flock;
+    ids = restoredIds;
+    neighborSums.reserve(count);
+
+    seed = header.seed;
+    std::memcpy(rng.state, header.rngState, sizeof(rng.state));
+    leader = FromSnapshot(header.leader);
+    previousLeader = FromSnapshot(header.previousLeader);
+    leaderInputDirection = FromSnapshot(header.leaderInputDirection);
+    flockCenter = FromSnapshot(header.flockCenter);
+    flockAverageVelocity = FromSnapshot(header.flockAverageVelocity);
+    smoothFlockCenter = FromSnapshot(header.smoothFlockCenter);
+    smoothFlockVelocity = FromSnapshot(header.smoothFlockVelocity);
+    previousSmoothFlockCenter = FromSnapshot(header.previousSmoothFlockCenter);
+    previousSmoothFlockVelocity = FromSnapshot(header.previousSmoothFlockVelocity);
+    return true;
+}
@@ -0,0 +1,60 @@
+#include "simulation/flock_soa.hpp"
+
+FlockSoA::FlockSoA() {
+
+}
+
+void FlockSoA::Reserve(size_t count) {
+    px.reserve(count); py.reserve(count); pz.reserve(count);
+    vx.reserve(count); vy.reserve(count); vz.reserve(count);
+    fx.reserve(count); fy.reserve(count); fz.reserve(count);
+    wingAngle.reserve(count);
+    wingSpeed.reserve(count);
+}
+
+void FlockSoA::Resize(size_t count) {
+    px.resize(count); py.resize(count); pz.resize(count);
+    vx.resize(count); vy.resize(count); vz.resize(count);
+    fx.resize(count); fy.resize(count); fz.resize(count);
+    wingAngle.resize(count);
+    wingSpeed.resize(count);
+}
+
+void FlockSoA::Clear() {
+    px.clear(); py.clear(); pz.clear();
+    vx.clear(); vy.clear(); vz.clear();
+    fx.clear(); fy.clear(); fz.clear();
+    wingAngle.clear();
+    wingSpeed.clear();
+}
+
+size_t FlockSoA::Add(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& forward,
+                     float angle, float speed) {
+    px.push_back(position.x); py.push_back(position.y); pz.push_back(position.z);
+    vx.push_back(velocity.x); vy.push_back(velocity.y); vz.push_back(velocity.z);
+    fx.push_back(forward.x);  fy.push_back(forward.y);  fz.push_back(forward.z);
+    wingAngle.push_back(angle);
+    wingSpeed.push_back(speed);
+    return px.size() - 1;
+}
+
+void FlockSoA::SwapRemove(size_t i) {
+    size_t last = px.size() - 1;
+    if (i != last) {
+        px[i] = px[last]; py[i] = py[last]; pz[i] = pz[last];
+        vx[i] = vx[last]; vy[i] = vy[last]; vz[i] = vz[last];
+        fx[i] = fx[last]; fy[i] = fy[last]; fz[i] = fz[last];
+        wingAngle[i] = wingAngle[last];
+        wingSpeed[i] = wingSpeed[last];
+    }
+    PopBack();
+}
+
+void FlockSoA::PopBack() {
+    if (px.empty()) return;
+    px.pop_back(); py.pop_back(); pz.pop_back();
+    vx.pop_back(); vy.pop_back(); vz.pop_back();
+    fx.pop_back(); fy.pop_back(); fz.pop_back();
+    wingAngle.pop_back();
+    wingSpeed.pop_back();
+}
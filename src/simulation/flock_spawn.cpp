@@ -0,0 +1,39 @@
+#include "simulation/flock_spawn.hpp"
+#include "simulation/flock_simulation.hpp"
+#include <algorithm>
+#include <cmath>
+
+float AutoSpawnRadius(SpawnShape shape, size_t count) {
+    const float PI = 3.14159265f;
+    float volume = (float)count * SEPARATION_RADIUS * SEPARATION_RADIUS * SEPARATION_RADIUS;
+    switch (shape) {
+        case SpawnShape::Box:
+            return 0.5f * std::cbrt(volume);
+        case SpawnShape::Ring:
+            // Anel de espessura ~SEPARATION_RADIUS: só a circunferência cresce com o bando
+            return std::max(2.0f, (float)count * SEPARATION_RADIUS / (2.0f * PI));
+        case SpawnShape::Sphere:
+        default:
+            return std::cbrt(3.0f * volume / (4.0f * PI));
+    }
+}
+
+glm::vec3 SampleSpawnOffset(SpawnShape shape, float radius, Random& rng) {
+    switch (shape) {
+        case SpawnShape::Box:
+            return glm::vec3(rng.Range(-radius, radius), rng.Range(-radius, radius), rng.Range(-radius, radius));
+        case SpawnShape::Ring: {
+            float angle = rng.Range(0.0f, 6.2831853f);
+            float r = radius * rng.Range(0.8f, 1.0f);
+            return glm::vec3(std::cos(angle) * r, rng.Range(-0.5f, 0.5f), std::sin(angle) * r);
+        }
+        case SpawnShape::Sphere:
+        default: {
+            // Rejeição no cubo: uniforme na bola, ~1.9 tentativas em média
+            while (true) {
+                glm::vec3 p(rng.Range(-1.0f, 1.0f), rng.Range(-1.0f, 1.0f), rng.Range(-1.0f, 1.0f));
+                if (glm::dot(p, p) <= 1.0f) return p * radius;
+            }
+        }
+    }
+}
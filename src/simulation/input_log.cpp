@@ -0,0 +1,287 @@
+#include "simulation/input_log.hpp"
+#include "simulation/flock_simulation.hpp"
+#include "simulation/flock_snapshot_file.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/trace.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+size_t AlignSection(size_t bytes) {
+    return (bytes + SNAPSHOT_SECTION_ALIGNMENT - 1) / SNAPSHOT_SECTION_ALIGNMENT * SNAPSHOT_SECTION_ALIGNMENT;
+}
+
+bool SameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Motivo pelo qual o registro não pode ser aplicado, ou nullptr se ele é válido.
+// Os valores viram contagens (size_t) e threads (int) na simulação: fora da faixa
+// seriam comportamento indefinido ou um bando/pool gigante.
+const char* InvalidRecordReason(const InputLogRecord& record) {
+    switch (record.kind) {
+        case INPUT_LOG_STEPS:
+            if (record.count == 0 || !std::isfinite(record.value) || record.value <= 0.0f) return "invalid step";
+            return nullptr;
+        case INPUT_LOG_CHECKSUM:
+            return nullptr;
+        case INPUT_LOG_COMMAND:
+            break;
+        default:
+            return "unknown record kind";
+    }
+
+    if (record.type > (uint32_t)SimCommand::SetDebugPrint) return "unknown command type";
+    if (record.shape > (uint32_t)SpawnShape::Ring) return "unknown spawn shape";
+    if (!std::isfinite(record.value) || !std::isfinite(record.vector[0]) ||
+        !std::isfinite(record.vector[1]) || !std::isfinite(record.vector[2])) {
+        return "non-finite value";
+    }
+    switch ((SimCommand::Type)record.type) {
+        case SimCommand::SpawnBoids:
+        case SimCommand::DespawnBoids:
+        case SimCommand::SetTargetCount:
+            if (record.value < 0.0f || record.value > INPUT_LOG_MAX_BOIDS) return "boid count out of range";
+            break;
+        case SimCommand::SetThreadCount:
+            if (record.value < 1.0f || record.value > (float)INPUT_LOG_MAX_THREADS) return "thread count out of range";
+            break;
+        case SimCommand::SetSteeringKernel:
+            if (record.value < 0.0f || record.value > (float)SteeringKernel::AVX2) return "unknown steering kernel";
+            break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+InputLog::InputLog() : sim(nullptr), stepCount(0) {
+    std::memset(&header, 0, sizeof(header));
+    std::memset(lastLeaderDirection, 0, sizeof(lastLeaderDirection));
+}
+
+bool InputLog::Start(const std::string& newPath, const FlockSimulation& source) {
+    if (Recording()) {
+        std::cout << "ERROR::INPUT_LOG::" << newPath << "::ALREADY_RECORDING " << path << std::endl;
+        return false;
+    }
+    path = newPath;
+    sim = &source;
+    records.clear();
+    stepCount = 0;
+    source.SaveSnapshot(snapshot);
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic));
+    header.version = INPUT_LOG_VERSION;
+    header.headerBytes = (uint32_t)sizeof(InputLogHeader);
+    header.endianTag = INPUT_LOG_ENDIAN_TAG;
+    header.steeringKernel = (uint32_t)source.steeringKernel;
+    header.useSpatialGrid = source.useSpatialGrid ? 1 : 0;
+    header.threadCount = (uint32_t)source.threadCount;
+
+    lastLeaderDirection[0] = source.leaderInputDirection.x;
+    lastLeaderDirection[1] = source.leaderInputDirection.y;
+    lastLeaderDirection[2] = source.leaderInputDirection.z;
+
+    printf("INFO::INPUT_LOG::RECORDING to %s from %zu boids\n", path.c_str(), source.Flock().Size());
+    return true;
+}
+
+void InputLog::Record(const SimCommand& command) {
+    if (command.type == SimCommand::SetLeaderDirection) {
+        float direction[3] = { command.vector.x, command.vector.y, command.vector.z };
+        if (SameBits(direction[0], lastLeaderDirection[0]) && SameBits(direction[1], lastLeaderDirection[1]) &&
+            SameBits(direction[2], lastLeaderDirection[2])) {
+            return;
+        }
+        std::memcpy(lastLeaderDirection, direction, sizeof(direction));
+    }
+
+    InputLogRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.kind = INPUT_LOG_COMMAND;
+    record.type = (uint32_t)command.type;
+    record.shape = (uint32_t)command.shape;
+    record.value = command.value;
+    record.vector[0] = command.vector.x;
+    record.vector[1] = command.vector.y;
+    record.vector[2] = command.vector.z;
+    records.push_back(record);
+}
+
+void InputLog::RecordStep(float dt) {
+    uint64_t step = stepCount.load(std::memory_order_relaxed);
+    if (step > 0 && checksumInterval > 0 && step % checksumInterval == 0) AddChecksum();
+
+    // Passos seguidos com o mesmo dt viram um registro só
+    if (!records.empty() && records.back().kind == INPUT_LOG_STEPS && SameBits(records.back().value, dt)) {
+        records.back().count++;
+    } else {
+        InputLogRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.kind = INPUT_LOG_STEPS;
+        record.count = 1;
+        record.value = dt;
+        records.push_back(record);
+    }
+    stepCount.store(step + 1, std::memory_order_relaxed);
+}
+
+void InputLog::AddChecksum() {
+    InputLogRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.kind = INPUT_LOG_CHECKSUM;
+    record.checksum = sim->Checksum();
+    records.push_back(record);
+}
+
+bool InputLog::Stop() {
+    if (!Recording()) return false;
+    TRACE_SCOPE("InputLog::Stop");
+    AddChecksum();
+    header.finalChecksum = records.back().checksum;
+    header.stepCount = StepCount();
+    header.recordCount = records.size();
+    header.snapshotOffset = AlignSection(sizeof(InputLogHeader));
+    header.snapshotBytes = snapshot.size();
+    header.recordOffset = AlignSection(header.snapshotOffset + snapshot.size());
+    sim = nullptr;
+
+    // Montado na memória e gravado numa escrita só; o snapshot fica alinhado para ser lido no lugar
+    size_t recordBytes = records.size() * sizeof(InputLogRecord);
+    std::vector<unsigned char> buffer((size_t)header.recordOffset + recordBytes, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + header.snapshotOffset, snapshot.data(), snapshot.size());
+    std::memcpy(buffer.data() + header.recordOffset, records.data(), recordBytes);
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::INPUT_LOG::" << tempPath << "::CANNOT_OPEN" << std::endl;
+        return false;
+    }
+    bool written = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    written = (fclose(file) == 0) && written;
+#ifdef _WIN32
+    // rename() do Windows não substitui um arquivo existente
+    if (written) std::remove(path.c_str());
+#endif
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cout << "ERROR::INPUT_LOG::" << path << "::WRITE_FAILED" << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    printf("INFO::INPUT_LOG::SAVED %llu steps, %zu records to %s (final checksum %016llx)\n",
+           (unsigned long long)header.stepCount, records.size(), path.c_str(), (unsigned long long)header.finalChecksum);
+    return true;
+}
+
+bool InputReplay::Open(const std::string& newPath, FlockSimulation& sim, const InputReplayOptions& newOptions) {
+    TRACE_SCOPE("InputReplay::Open");
+    path = newPath;
+    options = newOptions;
+    std::memset(&header, 0, sizeof(header));
+    if (!file.Open(path)) return false;
+
+    auto reject = [this](const char* reason) {
+        std::cout << "ERROR::INPUT_LOG::" << path << "::" << reason << std::endl;
+        return false;
+    };
+    if (file.Size() < sizeof(InputLogHeader)) return reject("TRUNCATED");
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic)) != 0) return reject("NOT_AN_INPUT_LOG");
+    if (header.endianTag != INPUT_LOG_ENDIAN_TAG) return reject("WRONG_BYTE_ORDER");
+    if (header.version != INPUT_LOG_VERSION || header.headerBytes != sizeof(InputLogHeader)) {
+        return reject("UNSUPPORTED_VERSION");
+    }
+    if (header.snapshotOffset % SNAPSHOT_SECTION_ALIGNMENT != 0 || header.recordOffset % sizeof(uint64_t) != 0 ||
+        header.snapshotOffset > file.Size() || header.snapshotBytes > file.Size() - header.snapshotOffset ||
+        header.recordOffset > file.Size() || header.recordCount != (file.Size() - header.recordOffset) / sizeof(InputLogRecord)) {
+        return reject("TRUNCATED");
+    }
+
+    // Os kernels SIMD arredondam diferente do escalar: a reprodução precisa do mesmo
+    if (header.steeringKernel > (uint32_t)SteeringKernel::AVX2) return reject("UNKNOWN_KERNEL");
+    SteeringKernel kernel = (SteeringKernel)header.steeringKernel;
+    if (!SteeringKernelSupported(kernel)) {
+        std::cout << "ERROR::INPUT_LOG::" << path << "::recorded with the " << SteeringKernelName(kernel)
+                  << " kernel, which this CPU does not support" << std::endl;
+        return false;
+    }
+    if (header.threadCount < 1 || header.threadCount > (uint32_t)INPUT_LOG_MAX_THREADS) return reject("BAD_THREAD_COUNT");
+    if (!sim.LoadSnapshot(file.Data() + header.snapshotOffset, (size_t)header.snapshotBytes, path)) return false;
+    sim.steeringKernel = kernel;
+    sim.useSpatialGrid = header.useSpatialGrid != 0;
+    sim.threadCount = options.threads > 0 ? options.threads : (int)header.threadCount;
+    return true;
+}
+
+bool InputReplay::Run(FlockSimulation& sim, InputReplayResult& result) {
+    TRACE_SCOPE("InputReplay::Run");
+    result = InputReplayResult();
+    const InputLogRecord* records = reinterpret_cast<const InputLogRecord*>(file.Data() + header.recordOffset);
+    for (uint64_t r = 0; r < header.recordCount; ++r) {
+        const InputLogRecord& record = records[r];
+        if (const char* reason = InvalidRecordReason(record)) {
+            std::cout << "ERROR::INPUT_LOG::" << path << "::BAD_RECORD " << r << " (" << reason << ")" << std::endl;
+            return false;
+        }
+        if (record.kind == INPUT_LOG_COMMAND && record.type == SimCommand::SetSteeringKernel &&
+            !SteeringKernelSupported((SteeringKernel)(int)record.value)) {
+            std::cout << "ERROR::INPUT_LOG::" << path << "::switches to the " << SteeringKernelName((SteeringKernel)(int)record.value)
+                      << " kernel at record " << r << ", which this CPU does not support" << std::endl;
+            return false;
+        }
+        switch (record.kind) {
+            case INPUT_LOG_COMMAND: {
+                SimCommand command((SimCommand::Type)record.type,
+                                   glm::vec3(record.vector[0], record.vector[1], record.vector[2]),
+                                   record.value, (SpawnShape)record.shape);
+                if (command.type == SimCommand::SetThreadCount && options.threads > 0) break;
+                // Os de controle do laço voltam false e não mudam nada
+                sim.Apply(command);
+                result.commands++;
+                break;
+            }
+            case INPUT_LOG_STEPS:
+                for (uint32_t i = 0; i < record.count; ++i) {
+                    auto start = std::chrono::steady_clock::now();
+                    sim.Step(record.value);
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    result.stepSeconds += seconds;
+                    if (seconds * 1000.0 > result.slowestStepMilliseconds) {
+                        result.slowestStepMilliseconds = seconds * 1000.0;
+                        result.slowestStep = result.steps;
+                    }
+                    result.steps++;
+                }
+                break;
+            case INPUT_LOG_CHECKSUM: {
+                unsigned long long checksum = sim.Checksum();
+                if (options.verbose) {
+                    printf("step %llu: checksum %016llx (recorded %016llx)\n", (unsigned long long)result.steps,
+                           checksum, (unsigned long long)record.checksum);
+                }
+                if (checksum != record.checksum) {
+                    result.diverged = true;
+                    result.divergedAtStep = result.steps;
+                    return true;
+                }
+                result.checksumsVerified++;
+                break;
+            }
+            default:
+                std::cout << "ERROR::INPUT_LOG::" << path << "::BAD_RECORD " << r << std::endl;
+                return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,168 @@
+#include "simulation/simulation_thread.hpp"
+#include "utils/trace.hpp"
+#include <chrono>
+
+FlockSnapshot::FlockSnapshot()
+    : previousLeader(),
+      leader(),
+      previousSmoothFlockCenter(0.0f),
+      smoothFlockCenter(0.0f),
+      previousSmoothFlockVelocity(0.0f, 0.0f, 1.0f),
+      smoothFlockVelocity(0.0f, 0.0f, 1.0f),
+      publishedAt(0.0),
+      stepSeconds(1.0f / 60.0f),
+      stepIndex(0),
+      droppedSteps(0),
+      stepMilliseconds(0.0f) {
+
+}
+
+void FlockSnapshot::Capture(const FlockSimulation& sim) {
+    // Atribuição reaproveita a capacidade dos vetores do slot: sem alocação depois do aquecimento
+    previousFlock = sim.PreviousFlock();
+    flock = sim.Flock();
+    previousLeader = sim.previousLeader;
+    leader = sim.leader;
+    previousSmoothFlockCenter = sim.previousSmoothFlockCenter;
+    smoothFlockCenter = sim.smoothFlockCenter;
+    previousSmoothFlockVelocity = sim.previousSmoothFlockVelocity;
+    smoothFlockVelocity = sim.smoothFlockVelocity;
+}
+
+SimulationThread::SimulationThread(FlockSimulation& s)
+    : sim(s),
+      running(false),
+      paused(false),
+      debugPrint(false),
+      stepsRequested(0),
+      stepIndex(0),
+      lastStepMilliseconds(0.0f),
+      steppedAt(0.0) {
+
+}
+
+SimulationThread::~SimulationThread() {
+    Stop();
+}
+
+double SimulationThread::Now() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::Start(float stepHz, bool startPaused, bool startDebugPrint) {
+    if (Running()) return;
+
+    clock.stepHz = stepHz;
+    clock.Reset();
+    paused = startPaused;
+    debugPrint = startDebugPrint;
+    stepsRequested = 0;
+
+    // O render já tem um snapshot válido antes do primeiro passo da thread
+    steppedAt = Now();
+    Publish();
+
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&SimulationThread::Loop, this);
+}
+
+void SimulationThread::Stop() {
+    if (!Running()) return;
+    running.store(false, std::memory_order_release);
+    thread.join();
+    // Entrada enviada depois do último passo não se perde ao voltar para a thread principal
+    ApplyCommands();
+}
+
+void SimulationThread::Push(const SimCommand& command) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    pending.push_back(command);
+}
+
+bool SimulationThread::ApplyCommands() {
+    bool stateChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        applying.swap(pending);
+    }
+
+    for (const SimCommand& command : applying) {
+        // Todo comando passa pelo FlockSimulation (que registra no log de entrada);
+        // os que ele não aplica são do laço
+        if (sim.Apply(command)) {
+            stateChanged = true;
+            continue;
+        }
+        switch (command.type) {
+            case SimCommand::SetPaused:
+                paused = command.value != 0.0f;
+                stepsRequested = 0;
+                clock.Reset();
+                break;
+            case SimCommand::SingleStep:
+                if (paused) stepsRequested++;
+                break;
+            case SimCommand::SetStepHz:
+                if (command.value > 0.0f) clock.stepHz = command.value;
+                break;
+            case SimCommand::SetDebugPrint:
+                debugPrint = command.value != 0.0f;
+                break;
+            default:
+                break;
+        }
+    }
+    applying.clear();
+    return stateChanged;
+}
+
+void SimulationThread::Publish() {
+    FlockSnapshot& snapshot = snapshots.WriteBuffer();
+    snapshot.Capture(sim);
+    snapshot.stepSeconds = clock.StepSeconds();
+    snapshot.stepIndex = stepIndex;
+    snapshot.droppedSteps = clock.droppedSteps;
+    snapshot.stepMilliseconds = lastStepMilliseconds;
+    snapshot.timings = sim.lastStepTimings;
+    snapshot.publishedAt = steppedAt;
+    snapshots.Publish();
+}
+
+void SimulationThread::Loop() {
+    Tracer::SetThreadName("simulation");
+    double lastTime = Now();
+
+    while (running.load(std::memory_order_acquire)) {
+        bool stateChanged = ApplyCommands();
+
+        double now = Now();
+        int steps;
+        if (paused) {
+            steps = stepsRequested;
+            stepsRequested = 0;
+        } else {
+            steps = clock.Advance(now - lastTime);
+        }
+        lastTime = now;
+
+        for (int i = 0; i < steps; ++i) {
+            double stepStart = Now();
+            sim.Step(clock.StepSeconds(), paused && debugPrint);
+            lastStepMilliseconds = (float)((Now() - stepStart) * 1000.0);
+            stepIndex++;
+        }
+        // Um snapshot por lote: estados intermediários nunca seriam desenhados. Sem
+        // passo, publica mesmo assim se um comando mudou o bando (spawn pausado etc.)
+        if (steps > 0) {
+            steppedAt = Now();
+            Publish();
+        } else if (stateChanged) {
+            Publish();
+        }
+
+        // Dorme até o próximo passo vencer (pausado: só espera por comandos)
+        double wait = paused ? clock.StepSeconds() : (1.0 - clock.Alpha()) * clock.StepSeconds();
+        std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+}
@@ -0,0 +1,107 @@
+#include "simulation/spatial_grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Índice do bit menos significativo ligado (bits != 0)
+static inline int LowestBit(unsigned long long bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int bit = 0;
+    while (!(bits & 1ull)) { bits >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+SpatialGrid::SpatialGrid() : cellSize(1.0f), invCellSize(1.0f), bucketMask(0) {
+
+}
+
+size_t SpatialGrid::BucketIndex(int cx, int cy, int cz) const {
+    // Hash clássico de Teschner et al. para coordenadas inteiras de célula
+    size_t h = ((size_t)(unsigned int)cx * 73856093u)
+             ^ ((size_t)(unsigned int)cy * 19349663u)
+             ^ ((size_t)(unsigned int)cz * 83492791u);
+    return h & bucketMask;
+}
+
+size_t SpatialGrid::BucketFor(const glm::vec3& position) const {
+    return BucketIndex((int)std::floor(position.x * invCellSize),
+                       (int)std::floor(position.y * invCellSize),
+                       (int)std::floor(position.z * invCellSize));
+}
+
+void SpatialGrid::Build(float size, const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z) {
+    cellSize = size;
+    invCellSize = 1.0f / size;
+
+    // Tabela com potência de 2 >= 2x o número de boids para poucas colisões
+    size_t count = x.size();
+    size_t bucketCount = 64;
+    while (bucketCount < count * 2) bucketCount <<= 1;
+    bucketMask = bucketCount - 1;
+
+    // Ordenação por contagem: conta, soma de prefixos e distribui.
+    // Percorrer os ids em ordem mantém cada bucket crescente.
+    bucketStart.assign(bucketCount + 1, 0);
+    entryBucket.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        entryBucket[i] = BucketFor(glm::vec3(x[i], y[i], z[i]));
+        bucketStart[entryBucket[i] + 1]++;
+    }
+    for (size_t b = 0; b < bucketCount; ++b) bucketStart[b + 1] += bucketStart[b];
+
+    entries.resize(count);
+    std::vector<int> cursor(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        entries[cursor[entryBucket[i]]++] = (int)i;
+    }
+}
+
+void SpatialGrid::Query(const glm::vec3& position, std::vector<int>& out) const {
+    out.clear();
+    if (entries.empty()) return;
+
+    int cx = (int)std::floor(position.x * invCellSize);
+    int cy = (int)std::floor(position.y * invCellSize);
+    int cz = (int)std::floor(position.z * invCellSize);
+
+    // Colisões de hash podem levar duas células ao mesmo bucket: visita cada bucket uma vez
+    size_t cells[27];
+    int cellCount = 0;
+    for (int dx = -1; dx <= 1; ++dx)
+        for (int dy = -1; dy <= 1; ++dy)
+            for (int dz = -1; dz <= 1; ++dz)
+                cells[cellCount++] = BucketIndex(cx + dx, cy + dy, cz + dz);
+    std::sort(cells, cells + cellCount);
+    cellCount = (int)(std::unique(cells, cells + cellCount) - cells);
+
+    // Concatena os buckets; cada id aparece no máximo uma vez
+    for (int c = 0; c < cellCount; ++c) {
+        int begin = bucketStart[cells[c]];
+        int end = bucketStart[cells[c] + 1];
+        out.insert(out.end(), entries.begin() + begin, entries.begin() + end);
+    }
+
+    // Ordem crescente reproduz exatamente a ordem de soma do laço força-bruta.
+    // Com poucos candidatos um sort basta; com muitos (bando denso) é mais barato
+    // marcar um bitmap de N bits e varrê-lo em ordem.
+    size_t words = (entries.size() + 63) / 64;
+    if (words > out.size() * 4) {
+        std::sort(out.begin(), out.end());
+        return;
+    }
+
+    thread_local std::vector<unsigned long long> bitmap;
+    bitmap.assign(words, 0ull);
+    for (int id : out) bitmap[id >> 6] |= 1ull << (id & 63);
+
+    out.clear();
+    for (size_t w = 0; w < words; ++w) {
+        unsigned long long bits = bitmap[w];
+        while (bits) {
+            out.push_back((int)(w * 64 + LowestBit(bits)));
+            bits &= bits - 1;
+        }
+    }
+}
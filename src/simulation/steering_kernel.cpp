@@ -0,0 +1,104 @@
+#include "simulation/steering_kernel.hpp"
+#include "simulation/flock_simulation.hpp"
+
+#if BOIDS_X86_KERNELS && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+void GatherNeighborsScalar(const FlockSoA& prev, size_t self, const int* candidates, size_t count, NeighborSums& sums) {
+    glm::vec3 position = prev.Position(self);
+    glm::vec3 separation(0.0f), alignment(0.0f), cohesion(0.0f);
+    int neighbors = 0;
+
+    for (size_t c = 0; c < count; ++c) {
+        size_t oi = (size_t)candidates[c];
+        if (oi == self) continue;
+
+        // Só posição e velocidade dos vizinhos são lidas: arrays quentes do SoA
+        glm::vec3 otherPos(prev.px[oi], prev.py[oi], prev.pz[oi]);
+        float dist = glm::distance(position, otherPos);
+        if (dist < PERCEPTION_RADIUS) {
+            cohesion += otherPos;
+            alignment += glm::vec3(prev.vx[oi], prev.vy[oi], prev.vz[oi]);
+            if (dist < SEPARATION_RADIUS) {
+                glm::vec3 push = position - otherPos;
+                separation += glm::normalize(push) / (dist * dist + 0.01f);
+            }
+            neighbors++;
+        }
+    }
+
+    sums.cohesion = cohesion;
+    sums.alignment = alignment;
+    sums.separation = separation;
+    sums.count = neighbors;
+}
+
+#if BOIDS_X86_KERNELS
+// CPUID folha 1 (ECX.19 = SSE4.1) e folha 7 (EBX.5 = AVX2), mais o OS salvando os
+// registradores YMM (OSXSAVE + XCR0 bits 1 e 2)
+static bool CpuHasSSE41() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool CpuHasAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+bool SteeringKernelSupported(SteeringKernel kernel) {
+    switch (kernel) {
+        case SteeringKernel::Scalar: return true;
+#if BOIDS_X86_KERNELS
+        case SteeringKernel::SSE4: return CpuHasSSE41();
+        case SteeringKernel::AVX2: return CpuHasAVX2();
+#endif
+        default: return false;
+    }
+}
+
+SteeringKernel BestSteeringKernel() {
+    static const SteeringKernel best =
+        SteeringKernelSupported(SteeringKernel::AVX2) ? SteeringKernel::AVX2 :
+        SteeringKernelSupported(SteeringKernel::SSE4) ? SteeringKernel::SSE4 :
+        SteeringKernel::Scalar;
+    return best;
+}
+
+SteeringKernelFn SelectSteeringKernel(SteeringKernel kernel) {
+    if (!SteeringKernelSupported(kernel)) return GatherNeighborsScalar;
+    switch (kernel) {
+#if BOIDS_X86_KERNELS
+        case SteeringKernel::SSE4: return GatherNeighborsSSE4;
+        case SteeringKernel::AVX2: return GatherNeighborsAVX2;
+#endif
+        default: return GatherNeighborsScalar;
+    }
+}
+
+const char* SteeringKernelName(SteeringKernel kernel) {
+    switch (kernel) {
+        case SteeringKernel::SSE4: return "sse4";
+        case SteeringKernel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,102 @@
+#include "simulation/steering_kernel.hpp"
+#include "simulation/flock_simulation.hpp"
+#include <immintrin.h>
+
+// Só estas funções são geradas com AVX2 (o resto do arquivo, inclusive glm e std
+// inline, segue o alvo base); GatherNeighborsAVX2 só é chamada se a CPU suportar
+#if defined(_MSC_VER)
+#define BOIDS_TARGET_AVX2
+#else
+#define BOIDS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+struct AVX2Lanes {
+    __m256 selfX, selfY, selfZ;
+    __m256i selfIndex;
+    __m256 cohX, cohY, cohZ;
+    __m256 aliX, aliY, aliZ;
+    __m256 sepX, sepY, sepZ;
+    __m256 neighbors;
+};
+
+BOIDS_TARGET_AVX2 inline float HorizontalSum(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    lo = _mm_add_ps(lo, hi);
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_movehdup_ps(lo));
+    return _mm_cvtss_f32(lo);
+}
+
+// 8 candidatos: teste de raio com distância ao quadrado e soma mascarada
+BOIDS_TARGET_AVX2 inline void Accumulate8(AVX2Lanes& l, const FlockSoA& prev, __m256i index) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    __m256 ox = _mm256_i32gather_ps(prev.px.data(), index, 4);
+    __m256 oy = _mm256_i32gather_ps(prev.py.data(), index, 4);
+    __m256 oz = _mm256_i32gather_ps(prev.pz.data(), index, 4);
+
+    // push = self - other
+    __m256 dx = _mm256_sub_ps(l.selfX, ox);
+    __m256 dy = _mm256_sub_ps(l.selfY, oy);
+    __m256 dz = _mm256_sub_ps(l.selfZ, oz);
+    __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+    __m256 isSelf = _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, l.selfIndex));
+    __m256 inRange = _mm256_andnot_ps(isSelf, _mm256_cmp_ps(d2, _mm256_set1_ps(PERCEPTION_RADIUS * PERCEPTION_RADIUS), _CMP_LT_OQ));
+    if (_mm256_movemask_ps(inRange) == 0) return;
+
+    __m256 vx = _mm256_i32gather_ps(prev.vx.data(), index, 4);
+    __m256 vy = _mm256_i32gather_ps(prev.vy.data(), index, 4);
+    __m256 vz = _mm256_i32gather_ps(prev.vz.data(), index, 4);
+
+    l.cohX = _mm256_add_ps(l.cohX, _mm256_and_ps(ox, inRange));
+    l.cohY = _mm256_add_ps(l.cohY, _mm256_and_ps(oy, inRange));
+    l.cohZ = _mm256_add_ps(l.cohZ, _mm256_and_ps(oz, inRange));
+    l.aliX = _mm256_add_ps(l.aliX, _mm256_and_ps(vx, inRange));
+    l.aliY = _mm256_add_ps(l.aliY, _mm256_and_ps(vy, inRange));
+    l.aliZ = _mm256_add_ps(l.aliZ, _mm256_and_ps(vz, inRange));
+    l.neighbors = _mm256_add_ps(l.neighbors, _mm256_and_ps(one, inRange));
+
+    // normalize(push) / (d² + 0.01) = push / (d * (d² + 0.01)); sqrt só aqui
+    __m256 close = _mm256_and_ps(_mm256_cmp_ps(d2, _mm256_set1_ps(SEPARATION_RADIUS * SEPARATION_RADIUS), _CMP_LT_OQ), inRange);
+    if (_mm256_movemask_ps(close) == 0) return;
+    __m256 scale = _mm256_div_ps(one, _mm256_mul_ps(_mm256_sqrt_ps(d2), _mm256_add_ps(d2, _mm256_set1_ps(0.01f))));
+    scale = _mm256_blendv_ps(_mm256_setzero_ps(), scale, close);
+    l.sepX = _mm256_add_ps(l.sepX, _mm256_mul_ps(dx, scale));
+    l.sepY = _mm256_add_ps(l.sepY, _mm256_mul_ps(dy, scale));
+    l.sepZ = _mm256_add_ps(l.sepZ, _mm256_mul_ps(dz, scale));
+}
+
+} // namespace
+
+BOIDS_TARGET_AVX2
+void GatherNeighborsAVX2(const FlockSoA& prev, size_t self, const int* candidates, size_t count, NeighborSums& sums) {
+    AVX2Lanes l;
+    l.selfX = _mm256_set1_ps(prev.px[self]);
+    l.selfY = _mm256_set1_ps(prev.py[self]);
+    l.selfZ = _mm256_set1_ps(prev.pz[self]);
+    l.selfIndex = _mm256_set1_epi32((int)self);
+    l.cohX = l.cohY = l.cohZ = _mm256_setzero_ps();
+    l.aliX = l.aliY = l.aliZ = _mm256_setzero_ps();
+    l.sepX = l.sepY = l.sepZ = _mm256_setzero_ps();
+    l.neighbors = _mm256_setzero_ps();
+
+    size_t c = 0;
+    for (; c + 8 <= count; c += 8) {
+        Accumulate8(l, prev, _mm256_loadu_si256((const __m256i*)(candidates + c)));
+    }
+    if (c < count) {
+        // Resto preenchido com o próprio boid, que a máscara descarta
+        int tail[8];
+        for (size_t k = 0; k < 8; ++k) tail[k] = c + k < count ? candidates[c + k] : (int)self;
+        Accumulate8(l, prev, _mm256_loadu_si256((const __m256i*)tail));
+    }
+
+    sums.cohesion = glm::vec3(HorizontalSum(l.cohX), HorizontalSum(l.cohY), HorizontalSum(l.cohZ));
+    sums.alignment = glm::vec3(HorizontalSum(l.aliX), HorizontalSum(l.aliY), HorizontalSum(l.aliZ));
+    sums.separation = glm::vec3(HorizontalSum(l.sepX), HorizontalSum(l.sepY), HorizontalSum(l.sepZ));
+    sums.count = (int)HorizontalSum(l.neighbors);
+}
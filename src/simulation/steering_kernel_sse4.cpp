@@ -0,0 +1,121 @@
+#include "simulation/steering_kernel.hpp"
+#include "simulation/flock_simulation.hpp"
+#include <smmintrin.h>
+
+// Só estas funções são geradas com SSE4.1; GatherNeighborsSSE4 só é chamada se a CPU suportar
+#if defined(_MSC_VER)
+#define BOIDS_TARGET_SSE4
+#else
+#define BOIDS_TARGET_SSE4 __attribute__((target("sse4.1")))
+#endif
+
+namespace {
+
+// 4 lanes por grupo; o laço processa dois grupos (8 candidatos) por iteração
+struct SSELanes {
+    __m128 cohX, cohY, cohZ;
+    __m128 aliX, aliY, aliZ;
+    __m128 sepX, sepY, sepZ;
+    __m128 neighbors;
+};
+
+struct SSESelf {
+    __m128 x, y, z;
+    __m128i index;
+};
+
+BOIDS_TARGET_SSE4 inline float HorizontalSum(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+BOIDS_TARGET_SSE4 inline void ClearLanes(SSELanes& l) {
+    l.cohX = l.cohY = l.cohZ = _mm_setzero_ps();
+    l.aliX = l.aliY = l.aliZ = _mm_setzero_ps();
+    l.sepX = l.sepY = l.sepZ = _mm_setzero_ps();
+    l.neighbors = _mm_setzero_ps();
+}
+
+// Sem gather no SSE: as 4 lanes são carregadas por índice
+BOIDS_TARGET_SSE4 inline void Accumulate4(SSELanes& l, const SSESelf& s, const FlockSoA& prev, const int* idx) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const float* px = prev.px.data();
+    const float* py = prev.py.data();
+    const float* pz = prev.pz.data();
+
+    __m128i index = _mm_loadu_si128((const __m128i*)idx);
+    __m128 ox = _mm_set_ps(px[idx[3]], px[idx[2]], px[idx[1]], px[idx[0]]);
+    __m128 oy = _mm_set_ps(py[idx[3]], py[idx[2]], py[idx[1]], py[idx[0]]);
+    __m128 oz = _mm_set_ps(pz[idx[3]], pz[idx[2]], pz[idx[1]], pz[idx[0]]);
+
+    // push = self - other
+    __m128 dx = _mm_sub_ps(s.x, ox);
+    __m128 dy = _mm_sub_ps(s.y, oy);
+    __m128 dz = _mm_sub_ps(s.z, oz);
+    __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+    __m128 isSelf = _mm_castsi128_ps(_mm_cmpeq_epi32(index, s.index));
+    __m128 inRange = _mm_andnot_ps(isSelf, _mm_cmplt_ps(d2, _mm_set1_ps(PERCEPTION_RADIUS * PERCEPTION_RADIUS)));
+    if (_mm_movemask_ps(inRange) == 0) return;
+
+    const float* vxs = prev.vx.data();
+    const float* vys = prev.vy.data();
+    const float* vzs = prev.vz.data();
+    __m128 vx = _mm_set_ps(vxs[idx[3]], vxs[idx[2]], vxs[idx[1]], vxs[idx[0]]);
+    __m128 vy = _mm_set_ps(vys[idx[3]], vys[idx[2]], vys[idx[1]], vys[idx[0]]);
+    __m128 vz = _mm_set_ps(vzs[idx[3]], vzs[idx[2]], vzs[idx[1]], vzs[idx[0]]);
+
+    l.cohX = _mm_add_ps(l.cohX, _mm_and_ps(ox, inRange));
+    l.cohY = _mm_add_ps(l.cohY, _mm_and_ps(oy, inRange));
+    l.cohZ = _mm_add_ps(l.cohZ, _mm_and_ps(oz, inRange));
+    l.aliX = _mm_add_ps(l.aliX, _mm_and_ps(vx, inRange));
+    l.aliY = _mm_add_ps(l.aliY, _mm_and_ps(vy, inRange));
+    l.aliZ = _mm_add_ps(l.aliZ, _mm_and_ps(vz, inRange));
+    l.neighbors = _mm_add_ps(l.neighbors, _mm_and_ps(one, inRange));
+
+    // normalize(push) / (d² + 0.01) = push / (d * (d² + 0.01)); sqrt só aqui
+    __m128 close = _mm_and_ps(_mm_cmplt_ps(d2, _mm_set1_ps(SEPARATION_RADIUS * SEPARATION_RADIUS)), inRange);
+    if (_mm_movemask_ps(close) == 0) return;
+    __m128 scale = _mm_div_ps(one, _mm_mul_ps(_mm_sqrt_ps(d2), _mm_add_ps(d2, _mm_set1_ps(0.01f))));
+    scale = _mm_blendv_ps(_mm_setzero_ps(), scale, close);
+    l.sepX = _mm_add_ps(l.sepX, _mm_mul_ps(dx, scale));
+    l.sepY = _mm_add_ps(l.sepY, _mm_mul_ps(dy, scale));
+    l.sepZ = _mm_add_ps(l.sepZ, _mm_mul_ps(dz, scale));
+}
+
+} // namespace
+
+BOIDS_TARGET_SSE4
+void GatherNeighborsSSE4(const FlockSoA& prev, size_t self, const int* candidates, size_t count, NeighborSums& sums) {
+    SSESelf s;
+    s.x = _mm_set1_ps(prev.px[self]);
+    s.y = _mm_set1_ps(prev.py[self]);
+    s.z = _mm_set1_ps(prev.pz[self]);
+    s.index = _mm_set1_epi32((int)self);
+
+    SSELanes a, b;
+    ClearLanes(a);
+    ClearLanes(b);
+
+    size_t c = 0;
+    for (; c + 8 <= count; c += 8) {
+        Accumulate4(a, s, prev, candidates + c);
+        Accumulate4(b, s, prev, candidates + c + 4);
+    }
+    if (c < count) {
+        // Resto preenchido com o próprio boid, que a máscara descarta
+        int tail[8];
+        for (size_t k = 0; k < 8; ++k) tail[k] = c + k < count ? candidates[c + k] : (int)self;
+        Accumulate4(a, s, prev, tail);
+        Accumulate4(b, s, prev, tail + 4);
+    }
+
+    sums.cohesion = glm::vec3(HorizontalSum(_mm_add_ps(a.cohX, b.cohX)), HorizontalSum(_mm_add_ps(a.cohY, b.cohY)),
+                              HorizontalSum(_mm_add_ps(a.cohZ, b.cohZ)));
+    sums.alignment = glm::vec3(HorizontalSum(_mm_add_ps(a.aliX, b.aliX)), HorizontalSum(_mm_add_ps(a.aliY, b.aliY)),
+                               HorizontalSum(_mm_add_ps(a.aliZ, b.aliZ)));
+    sums.separation = glm::vec3(HorizontalSum(_mm_add_ps(a.sepX, b.sepX)), HorizontalSum(_mm_add_ps(a.sepY, b.sepY)),
+                                HorizontalSum(_mm_add_ps(a.sepZ, b.sepZ)));
+    sums.count = (int)HorizontalSum(_mm_add_ps(a.neighbors, b.neighbors));
+}
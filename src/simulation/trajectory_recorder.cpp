@@ -0,0 +1,597 @@
+#include "simulation/trajectory_recorder.hpp"
+#include "simulation/flock_simulation.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const float QUANTIZATION_MAX = (float)((1u << TRAJECTORY_QUANTIZATION_BITS) - 1);
+
+void PutVarint(std::vector<unsigned char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((unsigned char)value);
+}
+
+bool GetVarint(const unsigned char*& p, const unsigned char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        unsigned char byte = *p++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// Diferenças pequenas (positivas ou negativas) viram varints de um byte
+uint64_t ZigZag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// Valor previsto a partir do frame anterior (p1) e do anterior a ele (p2)
+int64_t Prediction(TrajectoryPredictor predictor, uint32_t p1, uint32_t p2) {
+    switch (predictor) {
+        case TRAJECTORY_PREDICT_PREVIOUS: return (int64_t)p1;
+        case TRAJECTORY_PREDICT_LINEAR: return 2 * (int64_t)p1 - (int64_t)p2;
+        default: return 0;
+    }
+}
+
+int64_t Residual(TrajectoryPredictor predictor, uint32_t value, uint32_t p1, uint32_t p2) {
+    return (int64_t)value - Prediction(predictor, p1, p2);
+}
+
+size_t BitWidth(uint32_t value) {
+    size_t bits = 0;
+    while (value != 0) {
+        value >>= 1;
+        ++bits;
+    }
+    return bits;
+}
+
+// Resíduos em grupos de PACK_GROUP: um byte com a largura em bits do maior valor do
+// grupo e depois os valores com essa largura, bit a bit (menos significativo primeiro)
+const size_t PACK_GROUP = 64;
+
+size_t PackedBytes(const std::vector<uint32_t>& values) {
+    size_t bytes = 0;
+    for (size_t begin = 0; begin < values.size(); begin += PACK_GROUP) {
+        size_t end = std::min(begin + PACK_GROUP, values.size());
+        uint32_t any = 0;
+        for (size_t i = begin; i < end; ++i) any |= values[i];
+        bytes += 1 + ((end - begin) * BitWidth(any) + 7) / 8;
+    }
+    return bytes;
+}
+
+void PackBits(const std::vector<uint32_t>& values, std::vector<unsigned char>& out) {
+    for (size_t begin = 0; begin < values.size(); begin += PACK_GROUP) {
+        size_t end = std::min(begin + PACK_GROUP, values.size());
+        uint32_t any = 0;
+        for (size_t i = begin; i < end; ++i) any |= values[i];
+        size_t width = BitWidth(any);
+        out.push_back((unsigned char)width);
+
+        uint64_t pending = 0;
+        size_t pendingBits = 0;
+        for (size_t i = begin; i < end; ++i) {
+            pending |= (uint64_t)values[i] << pendingBits;
+            pendingBits += width;
+            while (pendingBits >= 8) {
+                out.push_back((unsigned char)pending);
+                pending >>= 8;
+                pendingBits -= 8;
+            }
+        }
+        if (pendingBits > 0) out.push_back((unsigned char)pending);
+    }
+}
+
+bool UnpackBits(const unsigned char*& p, const unsigned char* end, size_t count, std::vector<uint32_t>& values) {
+    values.resize(count);
+    for (size_t begin = 0; begin < count; begin += PACK_GROUP) {
+        size_t groupEnd = std::min(begin + PACK_GROUP, count);
+        if (p >= end) return false;
+        size_t width = *p++;
+        size_t bytes = ((groupEnd - begin) * width + 7) / 8;
+        if (width > 32 || bytes > (size_t)(end - p)) return false;
+
+        uint64_t mask = (1ull << width) - 1;
+        uint64_t pending = 0;
+        size_t pendingBits = 0;
+        for (size_t i = begin; i < groupEnd; ++i) {
+            while (pendingBits < width) {
+                pending |= (uint64_t)*p++ << pendingBits;
+                pendingBits += 8;
+            }
+            values[i] = (uint32_t)(pending & mask);
+            pending >>= width;
+            pendingBits -= width;
+        }
+    }
+    return true;
+}
+
+// Posição e velocidade de cada boid na ordem em que são gravadas (componente a
+// componente: todos os px, depois todos os py...)
+const std::vector<float>* Components(const TrajectoryFrame& frame, int c) {
+    const std::vector<float>* components[6] = { &frame.px, &frame.py, &frame.pz, &frame.vx, &frame.vy, &frame.vz };
+    return components[c];
+}
+
+} // namespace
+
+TrajectoryRecorder::TrajectoryRecorder()
+    : file(NULL), stopping(false),
+      framesCaptured(0), framesDropped(0), bytesWritten(0), rawBytes(0),
+      nextStep(0), nextFrame(0), writeFailed(false), history(0),
+      blockFrameCount(0), blockFirstFrame(0), fileOffset(0) {
+
+}
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+    Stop();
+    for (TrajectoryFrame* frame : allFrames) delete frame;
+}
+
+bool TrajectoryRecorder::Start(const std::string& newPath, const TrajectoryRecorderOptions& newOptions) {
+    if (Recording()) {
+        std::cout << "ERROR::TRAJECTORY::" << newPath << "::ALREADY_RECORDING " << path << std::endl;
+        return false;
+    }
+    file = fopen(newPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::TRAJECTORY::" << newPath << "::CANNOT_OPEN" << std::endl;
+        return false;
+    }
+    path = newPath;
+    options = newOptions;
+    options.blockFrames = std::max(options.blockFrames, 1);
+    options.queueFrames = std::max(options.queueFrames, 1);
+
+    framesCaptured = 0;
+    framesDropped = 0;
+    bytesWritten = 0;
+    rawBytes = 0;
+    nextStep = 0;
+    nextFrame = 0;
+    writeFailed = false;
+    previousIds.clear();
+    history = 0;
+    block.clear();
+    blockFrameCount = 0;
+    blockFirstFrame = 0;
+    fileOffset = 0;
+    index.clear();
+    queue.clear();
+    freeFrames = allFrames;
+    stopping = false;
+
+    TrajectoryFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TRAJECTORY_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRAJECTORY_FILE_VERSION;
+    header.headerBytes = (uint32_t)sizeof(TrajectoryFileHeader);
+    header.endianTag = TRAJECTORY_ENDIAN_TAG;
+    header.quantizationBits = TRAJECTORY_QUANTIZATION_BITS;
+    header.blockFrames = (uint32_t)options.blockFrames;
+    WriteBytes(&header, sizeof(header));
+
+    writer = std::thread(&TrajectoryRecorder::WriterLoop, this);
+    printf("INFO::TRAJECTORY::RECORDING to %s (%d frames per block)\n", path.c_str(), options.blockFrames);
+    return true;
+}
+
+void TrajectoryRecorder::Stop() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameReady.notify_all();
+    writer.join();
+
+    bool closed = fclose(file) == 0;
+    file = NULL;
+    if (writeFailed || !closed) {
+        std::cout << "ERROR::TRAJECTORY::" << path << "::WRITE_FAILED" << std::endl;
+        return;
+    }
+    uint64_t written = BytesWritten();
+    printf("INFO::TRAJECTORY::SAVED %llu frames (%llu dropped) to %s: %.1f MiB, %.1fx smaller than raw\n",
+           (unsigned long long)FramesCaptured(), (unsigned long long)FramesDropped(), path.c_str(),
+           written / (1024.0 * 1024.0), written > 0 ? (double)RawBytes() / written : 0.0);
+}
+
+void TrajectoryRecorder::Capture(const FlockSimulation& sim) {
+    if (!Recording()) return;
+    TRACE_SCOPE("TrajectoryRecorder::Capture");
+    uint64_t step = nextStep++;
+
+    TrajectoryFrame* frame = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (freeFrames.empty() && allFrames.size() < (size_t)options.queueFrames) {
+            allFrames.push_back(new TrajectoryFrame());
+            freeFrames.push_back(allFrames.back());
+        }
+        if (freeFrames.empty() && options.waitWhenFull) {
+            TRACE_SCOPE("TrajectoryRecorder::WaitForWriter");
+            frameFreed.wait(lock, [this] { return !freeFrames.empty(); });
+        }
+        if (freeFrames.empty()) {
+            framesDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        frame = freeFrames.back();
+        freeFrames.pop_back();
+    }
+
+    // Só cópias: os buffers são reaproveitados, então depois do primeiro giro da fila
+    // nada é alocado aqui
+    const FlockSoA& flock = sim.Flock();
+    frame->step = step;
+    frame->ids = sim.SlotIds();
+    frame->px = flock.px;
+    frame->py = flock.py;
+    frame->pz = flock.pz;
+    frame->vx = flock.vx;
+    frame->vy = flock.vy;
+    frame->vz = flock.vz;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(frame);
+    }
+    frameReady.notify_one();
+}
+
+void TrajectoryRecorder::WriterLoop() {
+    Tracer::SetThreadName("trajectory writer");
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        frameReady.wait(lock, [this] { return stopping || !queue.empty(); });
+        // Ao parar, a fila é esvaziada antes de sair
+        if (queue.empty()) break;
+
+        TrajectoryFrame* frame = queue.front();
+        queue.pop_front();
+        lock.unlock();
+
+        EncodeFrame(*frame);
+        if (blockFrameCount >= (uint32_t)options.blockFrames) FlushBlock();
+
+        lock.lock();
+        freeFrames.push_back(frame);
+        frameFreed.notify_one();
+    }
+    lock.unlock();
+
+    FlushBlock();
+
+    // Índice e rodapé: sem eles o arquivo ainda pode ser lido, percorrendo os blocos
+    TrajectoryFileTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    trailer.indexOffset = fileOffset;
+    trailer.blockCount = index.size();
+    trailer.frameCount = nextFrame;
+    std::memcpy(trailer.magic, TRAJECTORY_INDEX_MAGIC, sizeof(trailer.magic));
+    if (!index.empty()) WriteBytes(index.data(), index.size() * sizeof(TrajectoryIndexEntry));
+    WriteBytes(&trailer, sizeof(trailer));
+}
+
+void TrajectoryRecorder::EncodeFrame(const TrajectoryFrame& frame) {
+    TRACE_SCOPE("TrajectoryRecorder::EncodeFrame");
+    size_t count = frame.Size();
+
+    // Quadro-chave no início de cada bloco (decodificável sozinho) e sempre que o
+    // conjunto de boids mudou: os slots deixam de corresponder e não há o que subtrair
+    bool keyframe = blockFrameCount == 0 || frame.ids != previousIds;
+    if (blockFrameCount == 0) blockFirstFrame = nextFrame;
+
+    PutVarint(block, frame.step);
+    PutVarint(block, count);
+    block.push_back(keyframe ? 1 : 0);
+    if (keyframe) {
+        uint32_t previous = 0;
+        for (uint32_t id : frame.ids) {
+            PutVarint(block, ZigZag((int64_t)id - (int64_t)previous));
+            previous = id;
+        }
+        previousIds = frame.ids;
+    }
+
+    // Caixas envolventes do frame: [min xyz, max xyz] das posições e depois das velocidades
+    float bounds[12];
+    for (int c = 0; c < 6; ++c) {
+        const std::vector<float>& values = *Components(frame, c);
+        float low = 0.0f, high = 0.0f;
+        if (count > 0) {
+            auto range = std::minmax_element(values.begin(), values.end());
+            low = *range.first;
+            high = *range.second;
+        }
+        bounds[(c / 3) * 6 + c % 3] = low;
+        bounds[(c / 3) * 6 + 3 + c % 3] = high;
+    }
+    size_t boundsAt = block.size();
+    block.resize(boundsAt + sizeof(bounds));
+    std::memcpy(block.data() + boundsAt, bounds, sizeof(bounds));
+
+    for (int c = 0; c < 6; ++c) {
+        const std::vector<float>& values = *Components(frame, c);
+        float low = bounds[(c / 3) * 6 + c % 3];
+        float high = bounds[(c / 3) * 6 + 3 + c % 3];
+        float scale = high > low ? QUANTIZATION_MAX / (high - low) : 0.0f;
+
+        std::vector<uint32_t>& current = currentQuantized;
+        current.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            float q = (values[i] - low) * scale + 0.5f;
+            current[i] = (uint32_t)std::min(std::max(q, 0.0f), QUANTIZATION_MAX);
+        }
+
+        // Escolhe, por componente, o preditor que gera menos bytes neste frame
+        const std::vector<uint32_t>& previous = previousQuantized[c];
+        const std::vector<uint32_t>& older = olderQuantized[c];
+        auto residuals = [&](TrajectoryPredictor predictor, std::vector<uint32_t>& out) {
+            out.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t p1 = predictor == TRAJECTORY_PREDICT_NONE ? 0 : previous[i];
+                uint32_t p2 = predictor == TRAJECTORY_PREDICT_LINEAR ? older[i] : 0;
+                out[i] = (uint32_t)ZigZag(Residual(predictor, current[i], p1, p2));
+            }
+        };
+        TrajectoryPredictor predictor = keyframe ? TRAJECTORY_PREDICT_NONE : TRAJECTORY_PREDICT_PREVIOUS;
+        residuals(predictor, residualBuffer);
+        if (!keyframe && history >= 2) {
+            residuals(TRAJECTORY_PREDICT_LINEAR, candidateBuffer);
+            if (PackedBytes(candidateBuffer) < PackedBytes(residualBuffer)) {
+                predictor = TRAJECTORY_PREDICT_LINEAR;
+                residualBuffer.swap(candidateBuffer);
+            }
+        }
+        block.push_back((unsigned char)predictor);
+        PackBits(residualBuffer, block);
+
+        // O atual vira o anterior, o anterior vira o mais antigo
+        olderQuantized[c].swap(previousQuantized[c]);
+        previousQuantized[c].swap(current);
+    }
+    history = keyframe ? 1 : history + 1;
+
+    ++blockFrameCount;
+    ++nextFrame;
+    framesCaptured.fetch_add(1, std::memory_order_relaxed);
+    rawBytes.fetch_add(count * 7 * sizeof(float), std::memory_order_relaxed);
+}
+
+void TrajectoryRecorder::FlushBlock() {
+    if (blockFrameCount == 0) return;
+    TRACE_SCOPE("TrajectoryRecorder::FlushBlock");
+
+    TrajectoryIndexEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.firstFrame = blockFirstFrame;
+    entry.fileOffset = fileOffset;
+    entry.frameCount = blockFrameCount;
+    index.push_back(entry);
+
+    TrajectoryBlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.firstFrame = blockFirstFrame;
+    header.frameCount = blockFrameCount;
+    header.payloadBytes = block.size();
+    WriteBytes(&header, sizeof(header));
+    WriteBytes(block.data(), block.size());
+
+    block.clear();
+    blockFrameCount = 0;
+}
+
+void TrajectoryRecorder::WriteBytes(const void* data, size_t size) {
+    if (writeFailed || size == 0) return;
+    if (fwrite(data, 1, size, file) != size) {
+        writeFailed = true;
+        return;
+    }
+    fileOffset += size;
+    bytesWritten.fetch_add(size, std::memory_order_relaxed);
+}
+
+bool TrajectoryReader::Open(const std::string& path) {
+    blocks.clear();
+    frameCount = 0;
+    cachedBlock = -1;
+    if (!file.Open(path)) return false;
+
+    auto reject = [&path](const char* reason) {
+        std::cout << "ERROR::TRAJECTORY::" << path << "::" << reason << std::endl;
+        return false;
+    };
+    size_t size = file.Size();
+    if (size < sizeof(TrajectoryFileHeader)) return reject("TRUNCATED");
+
+    // Blocos e índice não ficam alinhados no arquivo, então tudo é lido com memcpy
+    TrajectoryFileHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, TRAJECTORY_FILE_MAGIC, sizeof(header.magic)) != 0) return reject("NOT_A_TRAJECTORY");
+    if (header.endianTag != TRAJECTORY_ENDIAN_TAG) return reject("WRONG_BYTE_ORDER");
+    if (header.version != TRAJECTORY_FILE_VERSION || header.headerBytes != sizeof(TrajectoryFileHeader) ||
+        header.quantizationBits != TRAJECTORY_QUANTIZATION_BITS) {
+        return reject("UNSUPPORTED_VERSION");
+    }
+
+    TrajectoryFileTrailer trailer;
+    bool indexed = false;
+    if (size >= sizeof(TrajectoryFileHeader) + sizeof(TrajectoryFileTrailer)) {
+        std::memcpy(&trailer, file.Data() + size - sizeof(trailer), sizeof(trailer));
+        indexed = std::memcmp(trailer.magic, TRAJECTORY_INDEX_MAGIC, sizeof(trailer.magic)) == 0 &&
+                  trailer.indexOffset >= sizeof(TrajectoryFileHeader) && trailer.indexOffset <= size &&
+                  trailer.blockCount == (size - sizeof(trailer) - trailer.indexOffset) / sizeof(TrajectoryIndexEntry) &&
+                  trailer.indexOffset + trailer.blockCount * sizeof(TrajectoryIndexEntry) + sizeof(trailer) == size;
+    }
+
+    if (indexed) {
+        blocks.resize((size_t)trailer.blockCount);
+        if (!blocks.empty()) {
+            std::memcpy(blocks.data(), file.Data() + trailer.indexOffset, blocks.size() * sizeof(TrajectoryIndexEntry));
+        }
+    } else {
+        // Gravação que não chegou ao Stop: aproveita os blocos completos
+        std::cout << "INFO::TRAJECTORY::" << path << "::NO_INDEX scanning blocks" << std::endl;
+        uint64_t offset = sizeof(TrajectoryFileHeader);
+        uint64_t nextFirst = 0;
+        while (offset + sizeof(TrajectoryBlockHeader) <= size) {
+            TrajectoryBlockHeader blockHeader;
+            std::memcpy(&blockHeader, file.Data() + offset, sizeof(blockHeader));
+            if (blockHeader.firstFrame != nextFirst || blockHeader.frameCount == 0 ||
+                blockHeader.payloadBytes > size - offset - sizeof(blockHeader)) {
+                break;
+            }
+            TrajectoryIndexEntry entry;
+            std::memset(&entry, 0, sizeof(entry));
+            entry.firstFrame = blockHeader.firstFrame;
+            entry.fileOffset = offset;
+            entry.frameCount = blockHeader.frameCount;
+            blocks.push_back(entry);
+            nextFirst += blockHeader.frameCount;
+            offset += sizeof(blockHeader) + blockHeader.payloadBytes;
+        }
+    }
+
+    // O índice precisa ser contínuo e apontar para dentro do arquivo
+    for (const TrajectoryIndexEntry& entry : blocks) {
+        if (entry.firstFrame != frameCount || entry.frameCount == 0 ||
+            entry.fileOffset < sizeof(TrajectoryFileHeader) || entry.fileOffset > size - sizeof(TrajectoryBlockHeader)) {
+            blocks.clear();
+            frameCount = 0;
+            return reject("BAD_INDEX");
+        }
+        frameCount += entry.frameCount;
+    }
+    return true;
+}
+
+bool TrajectoryReader::LoadBlock(size_t blockIndex) {
+    cachedBlock = -1;
+    const TrajectoryIndexEntry& entry = blocks[blockIndex];
+    TrajectoryBlockHeader header;
+    std::memcpy(&header, file.Data() + entry.fileOffset, sizeof(header));
+    uint64_t available = file.Size() - entry.fileOffset - sizeof(header);
+    if (header.firstFrame != entry.firstFrame || header.frameCount != entry.frameCount || header.payloadBytes > available) {
+        return false;
+    }
+    // Decodificado direto do mapeamento, sem copiar
+    blockData = file.Data() + entry.fileOffset + sizeof(header);
+    blockBytes = (size_t)header.payloadBytes;
+
+    cachedBlock = (long long)blockIndex;
+    cursor = 0;
+    decodedFrame = entry.firstFrame;
+    anyDecoded = false;
+    return true;
+}
+
+bool TrajectoryReader::DecodeNext() {
+    const unsigned char* p = blockData + cursor;
+    const unsigned char* end = blockData + blockBytes;
+
+    uint64_t count;
+    if (!GetVarint(p, end, step) || !GetVarint(p, end, count) || p >= end) return false;
+    bool keyframe = *p++ != 0;
+    // Sem quadro-chave o frame reaproveita os slots do anterior
+    if (!keyframe && (!anyDecoded || count != ids.size())) return false;
+    // Cada boid ocupa pelo menos um byte (o ID de um quadro-chave) ou um bit por componente
+    if (count > (uint64_t)(end - p) * 8) return false;
+
+    if (keyframe) {
+        ids.resize((size_t)count);
+        int64_t previous = 0;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            uint64_t delta;
+            if (!GetVarint(p, end, delta)) return false;
+            previous += UnZigZag(delta);
+            ids[i] = (uint32_t)previous;
+        }
+    }
+
+    if ((size_t)(end - p) < sizeof(bounds)) return false;
+    std::memcpy(bounds, p, sizeof(bounds));
+    p += sizeof(bounds);
+
+    for (int c = 0; c < 6; ++c) {
+        if (p >= end) return false;
+        TrajectoryPredictor predictor = (TrajectoryPredictor)*p++;
+        bool valid = keyframe ? predictor == TRAJECTORY_PREDICT_NONE
+                              : predictor == TRAJECTORY_PREDICT_PREVIOUS || (predictor == TRAJECTORY_PREDICT_LINEAR && history >= 2);
+        if (!valid) return false;
+
+        // Depois do laço 'older' guarda o frame anterior e 'values' o atual
+        std::vector<uint32_t>& values = quantized[c];
+        std::vector<uint32_t>& older = olderQuantized[c];
+        values.resize((size_t)count, 0);
+        older.resize((size_t)count, 0);
+        if (!UnpackBits(p, end, values.size(), residuals)) return false;
+        for (size_t i = 0; i < values.size(); ++i) {
+            int64_t prediction = Prediction(predictor, predictor == TRAJECTORY_PREDICT_NONE ? 0 : values[i], older[i]);
+            older[i] = values[i];
+            values[i] = (uint32_t)(prediction + UnZigZag(residuals[i]));
+        }
+    }
+    history = keyframe ? 1 : history + 1;
+
+    cursor = (size_t)(p - blockData);
+    anyDecoded = true;
+    return true;
+}
+
+bool TrajectoryReader::ReadFrame(uint64_t frame, TrajectoryFrame& out) {
+    if (frame >= frameCount) return false;
+    TRACE_SCOPE("TrajectoryReader::ReadFrame");
+
+    // Último bloco que começa antes ou no frame pedido
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), frame,
+                               [](uint64_t f, const TrajectoryIndexEntry& entry) { return f < entry.firstFrame; });
+    size_t blockIndex = (size_t)(it - blocks.begin()) - 1;
+
+    // Para frente dentro do bloco em cache continua de onde parou; senão volta ao quadro-chave
+    bool reuse = cachedBlock == (long long)blockIndex && anyDecoded && decodedFrame <= frame + 1;
+    if (!reuse && !LoadBlock(blockIndex)) {
+        std::cout << "ERROR::TRAJECTORY::BAD_BLOCK " << blockIndex << std::endl;
+        return false;
+    }
+    uint64_t next = decodedFrame;
+    for (; next <= frame; ++next) {
+        if (!DecodeNext()) {
+            cachedBlock = -1;
+            std::cout << "ERROR::TRAJECTORY::BAD_FRAME " << next << std::endl;
+            return false;
+        }
+    }
+    decodedFrame = next;
+
+    size_t count = ids.size();
+    out.step = step;
+    out.ids = ids;
+    std::vector<float>* components[6] = { &out.px, &out.py, &out.pz, &out.vx, &out.vy, &out.vz };
+    for (int c = 0; c < 6; ++c) {
+        float low = bounds[(c / 3) * 6 + c % 3];
+        float high = bounds[(c / 3) * 6 + 3 + c % 3];
+        float stepSize = (high - low) / QUANTIZATION_MAX;
+        std::vector<float>& values = *components[c];
+        values.resize(count);
+        for (size_t i = 0; i < count; ++i) values[i] = low + (float)quantized[c][i] * stepSize;
+    }
+    return true;
+}
@@ -0,0 +1,192 @@
+#include "utils/file_watcher.hpp"
+#include "utils/trace.hpp"
+#include <chrono>
+#include <iostream>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher()
+    : changes(0), stopping(false), usingInotify(false), pollIntervalMs(250), inotifyFd(-1), wakePipe{ -1, -1 } {
+
+}
+
+FileWatcher::~FileWatcher() {
+    Stop();
+}
+
+void FileWatcher::Watch(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const WatchedFile& f : files) {
+        if (f.path == path) return;
+    }
+
+    WatchedFile file;
+    file.path = path;
+    size_t slash = path.find_last_of("/\\");
+    file.directory = slash == std::string::npos ? "." : path.substr(0, slash);
+    file.name = slash == std::string::npos ? path : path.substr(slash + 1);
+    file.version = 0;
+    file.watchDescriptor = -1;
+    file.modTime = 0;
+    file.size = 0;
+    files.push_back(file);
+}
+
+void FileWatcher::Start(int intervalMs) {
+    if (Running()) return;
+    pollIntervalMs = intervalMs > 0 ? intervalMs : 250;
+    stopping = false;
+
+    if (StartInotify()) {
+        usingInotify = true;
+        thread = std::thread(&FileWatcher::InotifyLoop, this);
+    } else {
+        usingInotify = false;
+        for (size_t i = 0; i < files.size(); ++i) StatFile(i, files[i].modTime, files[i].size);
+        thread = std::thread(&FileWatcher::PollLoop, this);
+    }
+    std::cout << "INFO::FILE_WATCHER::WATCHING " << files.size() << " files ("
+              << (usingInotify ? "inotify" : "polling") << ")" << std::endl;
+}
+
+void FileWatcher::Stop() {
+    if (!Running()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+#ifdef __linux__
+    if (wakePipe[1] >= 0) {
+        char byte = 0;
+        ssize_t written = write(wakePipe[1], &byte, 1);
+        (void)written;
+    }
+#endif
+    thread.join();
+
+#ifdef __linux__
+    if (inotifyFd >= 0) close(inotifyFd);
+    if (wakePipe[0] >= 0) close(wakePipe[0]);
+    if (wakePipe[1] >= 0) close(wakePipe[1]);
+#endif
+    inotifyFd = -1;
+    wakePipe[0] = wakePipe[1] = -1;
+    usingInotify = false;
+}
+
+uint64_t FileWatcher::Version(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const WatchedFile& f : files) {
+        if (f.path == path) return f.version;
+    }
+    return 0;
+}
+
+void FileWatcher::MarkChanged(size_t index) {
+    // Called with mutex held
+    files[index].version++;
+    changes.fetch_add(1, std::memory_order_release);
+}
+
+bool FileWatcher::StatFile(size_t index, long long& modTime, long long& size) const {
+    struct stat info;
+    if (stat(files[index].path.c_str(), &info) != 0) return false;
+#ifdef __linux__
+    modTime = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#else
+    modTime = (long long)info.st_mtime;
+#endif
+    size = (long long)info.st_size;
+    return true;
+}
+
+void FileWatcher::PollLoop() {
+    Tracer::SetThreadName("file watcher");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        wakeCondition.wait_for(lock, std::chrono::milliseconds(pollIntervalMs));
+        if (stopping) break;
+        for (size_t i = 0; i < files.size(); ++i) {
+            long long modTime = 0, size = 0;
+            // A missing file (mid-save) is not a change; the next save will be
+            if (!StatFile(i, modTime, size)) continue;
+            if (modTime != files[i].modTime || size != files[i].size) {
+                files[i].modTime = modTime;
+                files[i].size = size;
+                MarkChanged(i);
+            }
+        }
+    }
+}
+
+#ifdef __linux__
+
+bool FileWatcher::StartInotify() {
+    inotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (inotifyFd < 0) return false;
+    if (pipe(wakePipe) != 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+        wakePipe[0] = wakePipe[1] = -1;
+        return false;
+    }
+
+    // Directories, not files: atomic saves replace the file's inode
+    for (WatchedFile& f : files) {
+        f.watchDescriptor = inotify_add_watch(inotifyFd, f.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (f.watchDescriptor < 0) {
+            std::cout << "ERROR::FILE_WATCHER::COULD_NOT_WATCH " << f.directory << ", falling back to polling" << std::endl;
+            close(inotifyFd);
+            close(wakePipe[0]);
+            close(wakePipe[1]);
+            inotifyFd = -1;
+            wakePipe[0] = wakePipe[1] = -1;
+            return false;
+        }
+    }
+    return true;
+}
+
+void FileWatcher::InotifyLoop() {
+    Tracer::SetThreadName("file watcher");
+    alignas(struct inotify_event) char buffer[4096];
+    pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { wakePipe[0], POLLIN, 0 } };
+    while (true) {
+        if (poll(fds, 2, -1) < 0) continue;
+        if (fds[1].revents) break;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        ssize_t length;
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (char* p = buffer; p < buffer + length;) {
+                const struct inotify_event* event = (const struct inotify_event*)p;
+                p += sizeof(struct inotify_event) + event->len;
+                if (event->len == 0) continue;
+
+                for (size_t i = 0; i < files.size(); ++i) {
+                    if (files[i].watchDescriptor == event->wd && files[i].name == event->name) MarkChanged(i);
+                }
+            }
+        }
+    }
+}
+
+#else
+
+bool FileWatcher::StartInotify() {
+    return false;
+}
+
+void FileWatcher::InotifyLoop() {
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include "utils/profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+TimingHistory::TimingHistory() : next(0), count(0) {
+    std::fill(samples, samples + CAPACITY, 0.0f);
+}
+
+void TimingHistory::Add(float milliseconds) {
+    samples[next] = milliseconds;
+    next = (next + 1) % CAPACITY;
+    if (count < CAPACITY) count++;
+}
+
+void TimingHistory::Clear() {
+    next = 0;
+    count = 0;
+}
+
+float TimingHistory::Latest() const {
+    if (count == 0) return 0.0f;
+    return samples[(next + CAPACITY - 1) % CAPACITY];
+}
+
+float TimingHistory::Min() const {
+    if (count == 0) return 0.0f;
+    return *std::min_element(samples, samples + count);
+}
+
+float TimingHistory::Max() const {
+    if (count == 0) return 0.0f;
+    return *std::max_element(samples, samples + count);
+}
+
+float TimingHistory::Average() const {
+    if (count == 0) return 0.0f;
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) sum += samples[i];
+    return (float)(sum / count);
+}
+
+float TimingHistory::Percentile(float p) const {
+    if (count == 0) return 0.0f;
+    float sorted[CAPACITY];
+    std::copy(samples, samples + count, sorted);
+    size_t rank = (size_t)std::ceil(p * count);
+    size_t index = rank == 0 ? 0 : std::min(rank - 1, count - 1);
+    std::nth_element(sorted, sorted + index, sorted + count);
+    return sorted[index];
+}
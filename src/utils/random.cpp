@@ -0,0 +1,41 @@
+#include "utils/random.hpp"
+
+Random::Random(uint64_t seed, uint64_t stream) {
+    Seed(seed, stream);
+}
+
+void Random::Seed(uint64_t seed, uint64_t stream) {
+    // SplitMix64 spreads any seed (even 0 or small integers) over the whole state
+    uint64_t x = seed;
+    for (int i = 0; i < 4; ++i) {
+        x += 0x9e3779b97f4a7c15ull;
+        uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        state[i] = z ^ (z >> 31);
+    }
+    for (uint64_t s = 0; s < stream; ++s) Jump();
+}
+
+void Random::Jump() {
+    static const uint64_t JUMP[] = {
+        0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+    };
+
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (uint64_t word : JUMP) {
+        for (int b = 0; b < 64; ++b) {
+            if (word & (1ull << b)) {
+                s0 ^= state[0];
+                s1 ^= state[1];
+                s2 ^= state[2];
+                s3 ^= state[3];
+            }
+            Next();
+        }
+    }
+    state[0] = s0;
+    state[1] = s1;
+    state[2] = s2;
+    state[3] = s3;
+}
@@ -0,0 +1,93 @@
+#include "utils/thread_pool.hpp"
+#include "utils/trace.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : job(nullptr), jobCount(0), jobGrain(1), nextChunk(0), chunksLeft(0), generation(0), stopping(false) {
+    Start(threadCount > 0 ? threadCount - 1 : 0);
+}
+
+ThreadPool::~ThreadPool() {
+    Stop();
+}
+
+size_t ThreadPool::HardwareThreads() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+void ThreadPool::Start(size_t workerCount) {
+    stopping = false;
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+void ThreadPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (auto& t : workers) t.join();
+    workers.clear();
+}
+
+void ThreadPool::Resize(size_t threadCount) {
+    if (threadCount < 1) threadCount = 1;
+    if (threadCount == ThreadCount()) return;
+    Stop();
+    Start(threadCount - 1);
+}
+
+void ThreadPool::RunChunks(std::unique_lock<std::mutex>& lock) {
+    while (job != nullptr && nextChunk < jobCount) {
+        size_t begin = nextChunk;
+        size_t end = begin + jobGrain < jobCount ? begin + jobGrain : jobCount;
+        nextChunk = end;
+        const std::function<void(size_t, size_t)>* fn = job;
+
+        lock.unlock();
+        (*fn)(begin, end);
+        lock.lock();
+
+        if (--chunksLeft == 0) doneCondition.notify_all();
+    }
+}
+
+void ThreadPool::WorkerLoop() {
+    Tracer::SetThreadName("pool worker");
+    unsigned long seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeCondition.wait(lock, [&] { return stopping || generation != seenGeneration; });
+        if (stopping) return;
+        seenGeneration = generation;
+        RunChunks(lock);
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    if (grain < 1) grain = 1;
+
+    // Nothing to share: skip the locking entirely, but keep the same chunk boundaries
+    if (workers.empty() || count <= grain) {
+        for (size_t begin = 0; begin < count; begin += grain) fn(begin, std::min(count, begin + grain));
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &fn;
+    jobCount = count;
+    jobGrain = grain;
+    nextChunk = 0;
+    chunksLeft = (count + grain - 1) / grain;
+    ++generation;
+    wakeCondition.notify_all();
+
+    // The caller works too, then waits for chunks still running on workers
+    RunChunks(lock);
+    doneCondition.wait(lock, [&] { return chunksLeft == 0; });
+    job = nullptr;
+}
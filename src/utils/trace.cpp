@@ -0,0 +1,165 @@
+#include "utils/trace.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Tracer::enabled(false);
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+// One ring per thread. Only the owning thread writes; 'written' is published
+// with release so a dump sees complete events up to that count.
+struct ThreadBuffer {
+    static const size_t CAPACITY = 1 << 16;
+
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> written;
+    // Events before this index went into an earlier dump (guarded by registryMutex)
+    uint64_t dumped;
+    unsigned int threadId;
+    std::string threadName;
+
+    explicit ThreadBuffer(unsigned int id) : events(CAPACITY), written(0), dumped(0), threadId(id) {}
+
+    // First event still held in the ring and not dumped yet
+    uint64_t FirstPending(uint64_t count) const {
+        uint64_t oldest = count > CAPACITY ? count - CAPACITY : 0;
+        return dumped > oldest ? dumped : oldest;
+    }
+};
+
+// Buffers are never freed, so spans from threads that already exited
+// (e.g. pool workers after a resize) still show up in the dump
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+thread_local ThreadBuffer* localBuffer = nullptr;
+// Name given before the thread recorded anything; the ring is only allocated on first use
+thread_local const char* localThreadName = nullptr;
+
+const auto traceEpoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& LocalBuffer() {
+    if (!localBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.emplace_back(new ThreadBuffer((unsigned int)registry.size() + 1));
+        localBuffer = registry.back().get();
+        if (localThreadName) localBuffer->threadName = localThreadName;
+    }
+    return *localBuffer;
+}
+
+void WriteEscaped(FILE* file, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        fputc(*c, file);
+    }
+}
+
+} // namespace
+
+void Tracer::SetThreadName(const char* name) {
+    localThreadName = name;
+    if (localBuffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        localBuffer->threadName = name;
+    }
+}
+
+uint64_t Tracer::NowNanoseconds() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+void Tracer::Record(const char* name, uint64_t beginNs, uint64_t endNs) {
+    ThreadBuffer& buffer = LocalBuffer();
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    // Pairs with the acquire fence in WriteJson: a dump that sees any part of this
+    // event also sees 'written' >= index, and drops the slot it overwrote
+    std::atomic_thread_fence(std::memory_order_release);
+    buffer.events[index % ThreadBuffer::CAPACITY] = TraceEvent{ name, beginNs, endNs };
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+size_t Tracer::EventCount() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t total = 0;
+    for (const auto& buffer : registry) {
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        total += (size_t)(written - buffer->FirstPending(written));
+    }
+    return total;
+}
+
+void Tracer::Clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& buffer : registry) {
+        buffer->written.store(0, std::memory_order_release);
+        buffer->dumped = 0;
+    }
+}
+
+bool Tracer::WriteJson(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::TRACE::COULD_NOT_OPEN_FILE " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    size_t count = 0;
+    size_t dropped = 0;
+    std::vector<TraceEvent> copy;
+    for (const auto& buffer : registry) {
+        if (!buffer->threadName.empty()) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                    first ? "" : ",\n", buffer->threadId);
+            WriteEscaped(file, buffer->threadName.c_str());
+            fputs("\"}}", file);
+            first = false;
+        }
+
+        // The owner keeps recording while we copy. Afterwards, every event the owner
+        // may have started writing in the meantime has index <= 'after', so its slot
+        // held index 'after - CAPACITY' or older: those copies are dropped.
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t start = buffer->FirstPending(written);
+        copy.resize((size_t)(written - start));
+        for (uint64_t i = start; i < written; ++i) copy[(size_t)(i - start)] = buffer->events[i % ThreadBuffer::CAPACITY];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = buffer->written.load(std::memory_order_relaxed);
+        uint64_t firstIntact = after >= ThreadBuffer::CAPACITY ? after - ThreadBuffer::CAPACITY + 1 : 0;
+        if (firstIntact > start) {
+            dropped += (size_t)((firstIntact < written ? firstIntact : written) - start);
+        }
+        buffer->dumped = written;
+
+        for (uint64_t i = start > firstIntact ? start : firstIntact; i < written; ++i) {
+            const TraceEvent& e = copy[(size_t)(i - start)];
+            // Complete events ("X"): timestamps and durations in microseconds
+            fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+            WriteEscaped(file, e.name);
+            fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer->threadId, e.beginNs / 1000.0, (e.endNs - e.beginNs) / 1000.0);
+            first = false;
+            count++;
+        }
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+
+    std::cout << "INFO::TRACE::WROTE " << count << " spans to " << path;
+    if (dropped > 0) std::cout << " (" << dropped << " dropped: their ring slots were being reused)";
+    std::cout << std::endl;
+    return true;
+}
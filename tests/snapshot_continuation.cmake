@@ -0,0 +1,27 @@
+# Salvar no meio e continuar com --load precisa chegar ao mesmo estado de uma
+# execução direta. Uso: cmake -DHEADLESS=<boids-headless> -DWORK_DIR=<dir> -P snapshot_continuation.cmake
+set(RUN_ARGS --seed 7 --boids 1000 --threads 2)
+
+function(run_headless output_var)
+    execute_process(COMMAND ${HEADLESS} ${ARGN}
+                    RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "boids-headless ${ARGN} failed (${result}):\n${output}")
+    endif()
+    string(REGEX MATCH "final checksum: ([0-9a-f]+)" match "${output}")
+    if (NOT match)
+        message(FATAL_ERROR "no final checksum in the output of boids-headless ${ARGN}:\n${output}")
+    endif()
+    set(${output_var} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+set(SNAPSHOT ${WORK_DIR}/continuation.snapshot)
+file(REMOVE ${SNAPSHOT})
+run_headless(straight ${RUN_ARGS} --steps 200)
+run_headless(first_half ${RUN_ARGS} --steps 100 --save ${SNAPSHOT})
+run_headless(continued --load ${SNAPSHOT} --threads 2 --steps 100)
+
+if (NOT continued STREQUAL straight)
+    message(FATAL_ERROR "save/load continuation diverged: ${continued}, straight run ${straight}")
+endif()
+message(STATUS "continuation matches the straight run: ${straight}")
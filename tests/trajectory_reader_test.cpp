@@ -0,0 +1,146 @@
+// Confere o TrajectoryReader contra uma gravação pequena: saltos aleatórios contra a
+// decodificação sequencial, o mesmo frame lido duas vezes (reaproveita o estado em
+// cache) e arquivos cortados sem índice (varredura dos blocos).
+//
+// Uso: trajectory-reader-test DIR   (grava os arquivos em DIR; sai com 1 se algo falhar)
+#include "simulation/flock_simulation.hpp"
+#include "simulation/trajectory_recorder.hpp"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what, unsigned long long frame) {
+    if (ok) return;
+    printf("FAIL: %s (frame %llu)\n", what, frame);
+    failures++;
+}
+
+static bool SameFrame(const TrajectoryFrame& a, const TrajectoryFrame& b) {
+    return a.step == b.step && a.ids == b.ids && a.px == b.px && a.py == b.py && a.pz == b.pz &&
+           a.vx == b.vx && a.vy == b.vy && a.vz == b.vz;
+}
+
+// Copia os primeiros 'bytes' de 'source' para 'path'
+static bool WritePrefix(const std::string& source, const std::string& path, size_t bytes) {
+    std::vector<unsigned char> data(bytes);
+    FILE* in = fopen(source.c_str(), "rb");
+    if (!in) return false;
+    bool ok = fread(data.data(), 1, bytes, in) == bytes;
+    fclose(in);
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) return false;
+    ok = fwrite(data.data(), 1, bytes, out) == bytes && ok;
+    return fclose(out) == 0 && ok;
+}
+
+static long FileSize(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        printf("Usage: trajectory-reader-test DIR\n");
+        return 1;
+    }
+    const std::string dir = argv[1];
+    const std::string path = dir + "/reader_test.traj";
+    const int BLOCK_FRAMES = 8;
+    const int STEPS = 60;
+
+    // Bando pequeno; no meio, boids saem e entram para forçar quadros-chave fora do início do bloco
+    FlockSimulation sim;
+    sim.Seed(11);
+    sim.threadCount = 1;
+    SpawnParams params;
+    params.shape = SpawnShape::Box;
+    params.center = sim.leader.position;
+    params.radius = 10.0f;
+    params.count = 400;
+    sim.Spawn(params);
+
+    TrajectoryRecorder recorder;
+    TrajectoryRecorderOptions options;
+    options.blockFrames = BLOCK_FRAMES;
+    options.waitWhenFull = true;
+    if (!recorder.Start(path, options)) return 1;
+    sim.recorder = &recorder;
+    for (int step = 0; step < STEPS; ++step) {
+        if (step == 21) sim.Despawn(30);
+        if (step == 37) {
+            params.count = 15;
+            sim.Spawn(params);
+        }
+        sim.Step(1.0f / 60.0f);
+    }
+    sim.recorder = nullptr;
+    recorder.Stop();
+
+    TrajectoryReader reader;
+    if (!reader.Open(path) || reader.FrameCount() != (uint64_t)STEPS) {
+        printf("FAIL: cannot open %s or wrong frame count\n", path.c_str());
+        return 1;
+    }
+
+    // Referência: todos os frames em ordem, num leitor só
+    std::vector<TrajectoryFrame> sequential(STEPS);
+    for (int f = 0; f < STEPS; ++f) {
+        Check(reader.ReadFrame((uint64_t)f, sequential[f]), "sequential read", f);
+        Check(sequential[f].step == (uint64_t)f, "frame step", f);
+    }
+    Check(sequential[STEPS - 1].ids == sim.SlotIds(), "last frame ids match the simulation", STEPS - 1);
+    TrajectoryFrame frame;
+    Check(!reader.ReadFrame((uint64_t)STEPS, frame), "read past the end fails", STEPS);
+
+    // Saltos aleatórios (para trás, para frente, entre blocos) dão o mesmo que a leitura sequencial
+    std::mt19937 random(5);
+    for (int i = 0; i < 300; ++i) {
+        uint64_t f = random() % STEPS;
+        Check(reader.ReadFrame(f, frame) && SameFrame(frame, sequential[f]), "random seek", f);
+    }
+
+    // O mesmo frame duas vezes seguidas usa o estado já decodificado (decodedFrame == frame + 1)
+    for (uint64_t f = 0; f < (uint64_t)STEPS; f += 5) {
+        TrajectoryFrame again;
+        Check(reader.ReadFrame(f, frame) && reader.ReadFrame(f, again), "repeated read", f);
+        Check(SameFrame(frame, sequential[f]) && SameFrame(again, sequential[f]), "repeated read matches", f);
+    }
+
+    // Sem índice: a varredura dos blocos acha todos eles (corte logo antes do índice) ou
+    // só os completos (corte no meio do último bloco)
+    long size = FileSize(path);
+    size_t blocks = reader.BlockCount();
+    size_t indexBytes = blocks * sizeof(TrajectoryIndexEntry) + sizeof(TrajectoryFileTrailer);
+    uint64_t lastBlockFrames = (uint64_t)STEPS - (uint64_t)(blocks - 1) * BLOCK_FRAMES;
+    struct Cut {
+        size_t bytes;
+        uint64_t expectedFrames;
+    } cuts[] = {
+        { (size_t)size - indexBytes, (uint64_t)STEPS },
+        { (size_t)size - indexBytes - 16, (uint64_t)STEPS - lastBlockFrames },
+    };
+    for (const Cut& cut : cuts) {
+        std::string truncatedPath = dir + "/reader_test_truncated.traj";
+        TrajectoryReader truncated;
+        if (!WritePrefix(path, truncatedPath, cut.bytes) || !truncated.Open(truncatedPath)) {
+            printf("FAIL: cannot open the file cut at %zu bytes\n", cut.bytes);
+            failures++;
+            continue;
+        }
+        Check(truncated.FrameCount() == cut.expectedFrames, "block scan frame count", cut.expectedFrames);
+        for (uint64_t f = 0; f < truncated.FrameCount(); ++f) {
+            Check(truncated.ReadFrame(f, frame) && SameFrame(frame, sequential[f]), "truncated file read", f);
+        }
+        Check(!truncated.ReadFrame(truncated.FrameCount(), frame), "truncated read past the end fails", truncated.FrameCount());
+    }
+
+    printf("trajectory reader: %d frames in %zu blocks, %s\n", STEPS, blocks, failures == 0 ? "OK" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}